@@ -0,0 +1,64 @@
+// SFML 3.x
+
+#pragma once
+#include "ResourceManager.h"
+#include "SymbolTable.h"
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Loads a declared batch of assets in parallel. Files are read and decoded on the shared
+// ThreadPool into CPU-side images, fonts and sound buffers; GPU texture uploads and music
+// streams are then created on the calling (main) thread.
+class AssetLoader {
+public:
+    struct Timing {
+        std::string id;
+        std::string path;
+        double workerMs = 0.0;  // Reading and decoding on a pool thread
+        double mainMs = 0.0;    // Texture upload / stream open on the main thread
+        bool loaded = false;
+    };
+
+    void addTexture(Symbol id, const std::string& path);
+    void addTexture(const std::string& id, const std::string& path) { addTexture(intern(id), path); }
+    void addFont(const std::string& id, const std::string& path);
+    void addSoundBuffer(const std::string& id, const std::string& path);
+    void addMusic(const std::string& id, const std::string& path);
+
+    // CPU-only image (e.g. the window icon), retrieved with takeImage after load.
+    // A non-zero maxSize downscales it to fit on the worker.
+    void addImage(Symbol id, const std::string& path, sf::Vector2u maxSize = {});
+    void addImage(const std::string& id, const std::string& path) { addImage(intern(id), path); }
+
+    // Load everything declared so far into resources. Returns false if any asset failed.
+    bool load(ResourceManager& resources);
+
+    // Image decoded for addImage(id, ...), if it loaded
+    std::optional<sf::Image> takeImage(Symbol id);
+    std::optional<sf::Image> takeImage(const std::string& id) { return takeImage(SymbolTable::global().find(id)); }
+
+    const std::vector<Timing>& getTimings() const { return timings; }
+    double getTotalMs() const { return totalMs; }
+
+    // Per-asset table plus the wall-clock total
+    void printReport(std::ostream& out) const;
+
+private:
+    enum class Kind { Texture, Font, SoundBuffer, Music, Image };
+
+    struct Request {
+        Kind kind;
+        Symbol id;
+        std::string path;
+        sf::Vector2u maxSize;  // Images only
+    };
+
+    std::vector<Request> requests;
+    std::vector<Timing> timings;
+    std::vector<std::pair<Symbol, sf::Image>> images;
+    double totalMs = 0.0;
+};
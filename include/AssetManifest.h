@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+enum class AssetFormat : std::uint8_t {
+    Unknown,
+    Jpeg,
+    Png,
+    Font,
+    Wav,
+    Ogg,
+    Mp3,
+    Flac,
+    Json,
+};
+
+// What the manifest knows about one asset without opening it
+struct AssetInfo {
+    std::string id;    // Logical id: path below the asset root without extension ("images/bg_void")
+    std::string path;  // Path to load, as used with ResourceManager ("assets/images/bg_void.jpeg")
+    AssetFormat format = AssetFormat::Unknown;
+    std::uint32_t width = 0;   // Pixel size for images, 0 otherwise
+    std::uint32_t height = 0;
+    std::uint64_t bytes = 0;   // Encoded size on disk
+
+    // RGBA size once decoded (what the texture cache budgets), 0 for non-images
+    std::size_t decodedBytes() const { return static_cast<std::size_t>(width) * height * 4; }
+};
+
+// Maps logical asset ids to their real file, format and size. Generated at build time by
+// packassets (shipped inside the pack and as assets/manifest.json); scanned at startup if missing.
+// When several files share an id (bg.jpeg and bg.png) the jpeg wins, like the old probing order.
+class AssetManifest {
+public:
+    static constexpr const char* DEFAULT_PATH = "assets/manifest.json";
+    static constexpr std::uint32_t VERSION = 1;
+
+    // Index every recognised file under root, reading only image headers. Paths are stored
+    // as pathPrefix + relative path; skip lists files or directories relative to root.
+    bool scan(const std::string& root, const std::string& pathPrefix, const std::vector<std::string>& skip = {});
+
+    bool loadFromFile(const std::string& path);
+    bool loadFromMemory(const void* data, std::size_t size);
+    bool saveToFile(const std::string& path) const;
+    std::string toJsonString() const;
+
+    // nullptr if the id / path is unknown
+    const AssetInfo* find(const std::string& id) const;
+    const AssetInfo* findByPath(const std::string& path) const;
+
+    const std::vector<AssetInfo>& getAssets() const { return assets; }
+    std::size_t size() const { return assets.size(); }
+    bool empty() const { return assets.empty(); }
+    void clear();
+
+    static AssetFormat formatForExtension(const std::string& extension);
+    static const char* formatName(AssetFormat format);
+    static AssetFormat formatFromName(const std::string& name);
+
+private:
+    void add(AssetInfo info);
+
+    std::vector<AssetInfo> assets;  // Sorted by id
+    std::unordered_map<std::string, std::size_t> byId;
+    std::unordered_map<std::string, std::size_t> byPath;
+};
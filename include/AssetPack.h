@@ -0,0 +1,41 @@
+#pragma once
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Read-only view of an asset pack (see AssetPackFormat.h). The whole archive is mapped once;
+// lookups hash the path and return a pointer into the mapping, so there is no per-asset I/O.
+// Safe to query from several threads once open.
+class AssetPack {
+public:
+    struct Blob {
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+    };
+
+    // Map and validate the archive, replacing any previously opened one
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return file.isOpen(); }
+    std::size_t size() const { return entryCount; }
+
+    // Contents of the file stored under path, or nullopt if the pack does not have it
+    std::optional<Blob> find(std::string_view path) const;
+
+    // Cheap identity of a blob from this pack: the pack file's mtime and size with the blob's
+    // offset and size. Changes whenever the pack is rebuilt; never 0.
+    std::int64_t entryStamp(const Blob& blob) const;
+
+private:
+    MappedFile file;
+    std::uint32_t entryCount = 0;
+    std::uint32_t slotCount = 0;
+    std::uint32_t entryTableOffset = 0;
+    std::uint32_t slotTableOffset = 0;
+    std::uint32_t nameTableOffset = 0;
+    std::uint64_t packStamp = 0;  // From the pack file's mtime and size
+};
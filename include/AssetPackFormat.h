@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+// On-disk layout of the asset pack (assets.pak), produced by packassets and mmapped by AssetPack.
+// Every field is a 32-bit little-endian value and every offset is relative to the start of the file.
+//
+//   PackHeader
+//   PackEntry[entryCount]        one per file, sorted by path
+//   uint32_t[slotCount]          open-addressing hash table of entry indices (kEmptySlot if free)
+//   name pool                    UTF-8 asset paths, not null-terminated
+//   blobs                        file contents, each starting on a kBlobAlignment boundary
+namespace AssetPackFormat {
+
+constexpr char kMagic[4] = {'U', 'A', 'P', 'K'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kBlobAlignment = 64;
+constexpr std::uint32_t kEmptySlot = 0xFFFFFFFFu;
+constexpr const char* kDefaultPackPath = "assets.pak";
+
+struct PackHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t entryCount;
+    std::uint32_t slotCount;  // Power of two, at least twice entryCount
+    std::uint32_t entryTableOffset;
+    std::uint32_t slotTableOffset;
+    std::uint32_t nameTableOffset;
+    std::uint32_t nameTableSize;
+};
+
+struct PackEntry {
+    std::uint32_t hash;  // hashPath of the name
+    std::uint32_t nameOffset;
+    std::uint32_t nameLength;
+    std::uint32_t dataOffset;
+    std::uint32_t dataSize;
+};
+
+// FNV-1a over the asset path exactly as the game asks for it (e.g. "assets/images/logo.png")
+constexpr std::uint32_t hashPath(std::string_view path) {
+    std::uint32_t hash = 2166136261u;
+    for (char c : path) {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// First probe position of hash in a table of slotCount slots
+constexpr std::uint32_t firstSlot(std::uint32_t hash, std::uint32_t slotCount) {
+    return hash & (slotCount - 1);
+}
+
+static_assert(std::is_trivially_copyable_v<PackHeader>, "records are read straight from the mapping");
+static_assert(std::is_trivially_copyable_v<PackEntry>, "records are read straight from the mapping");
+static_assert(sizeof(PackHeader) % 4 == 0 && sizeof(PackEntry) % 4 == 0, "tables must stay 4-byte aligned");
+
+} // namespace AssetPackFormat
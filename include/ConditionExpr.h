@@ -0,0 +1,145 @@
+#pragma once
+#include "SymbolTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Expression conditions on choices, written in the script as
+//
+//   "condition": {"expr": "items(feather) >= 3 && stat(courage) >= 2 || has_bronze_key"}
+//
+// Grammar, loosest binding first:
+//
+//   or       := and (("||" | "or") and)*
+//   and      := unary (("&&" | "and") unary)*
+//   unary    := ("!" | "not") unary | compare
+//   compare  := operand (("==" | "!=" | "<" | "<=" | ">" | ">=") operand)?
+//   operand  := ["-"] integer | "true" | "false" | name | flag(name) | stat(name) | items(name)
+//             | "(" or ")"
+//
+// A bare name is a flag. Every value is an int: flags, comparisons and logic give 0 or 1,
+// stat() is the stat's value (0 if unset) and items() the number held. A condition passes
+// when the result is non-zero. Expressions are parsed once when the script is loaded and
+// compiled to a ConditionProgram; the tree is only kept for tools.
+//
+// Evaluation reads game state through any type with these members:
+//
+//   bool flag(Symbol) const;  int stat(Symbol) const;  int items(Symbol) const;
+
+// Parsed expression
+struct ExprNode {
+    enum class Kind : std::uint8_t { Constant, Flag, Stat, Items, Not, And, Or, Compare };
+    enum class Compare : std::uint8_t { Eq, Ne, Lt, Le, Gt, Ge };
+
+    Kind kind = Kind::Constant;
+    Compare compare = Compare::Eq;
+    std::int32_t value = 0;             // Constant
+    Symbol symbol = NO_SYMBOL;          // Flag, Stat, Items
+    std::unique_ptr<ExprNode> left;     // Operand of Not; left side otherwise
+    std::unique_ptr<ExprNode> right;
+};
+
+// Parse source into a tree; nullptr with a message in error if it is malformed
+std::unique_ptr<ExprNode> parseCondition(std::string_view source, std::string& error);
+
+// Evaluate a tree directly, recursing through the nodes (the reference for ConditionProgram)
+template <typename State>
+std::int32_t evaluateTree(const ExprNode& node, const State& state) {
+    using Kind = ExprNode::Kind;
+    switch (node.kind) {
+        case Kind::Constant: return node.value;
+        case Kind::Flag: return state.flag(node.symbol) ? 1 : 0;
+        case Kind::Stat: return state.stat(node.symbol);
+        case Kind::Items: return state.items(node.symbol);
+        case Kind::Not: return evaluateTree(*node.left, state) == 0;
+        case Kind::And: return evaluateTree(*node.left, state) != 0 && evaluateTree(*node.right, state) != 0;
+        case Kind::Or: return evaluateTree(*node.left, state) != 0 || evaluateTree(*node.right, state) != 0;
+        case Kind::Compare: {
+            std::int32_t a = evaluateTree(*node.left, state);
+            std::int32_t b = evaluateTree(*node.right, state);
+            switch (node.compare) {
+                case ExprNode::Compare::Eq: return a == b;
+                case ExprNode::Compare::Ne: return a != b;
+                case ExprNode::Compare::Lt: return a < b;
+                case ExprNode::Compare::Le: return a <= b;
+                case ExprNode::Compare::Gt: return a > b;
+                case ExprNode::Compare::Ge: return a >= b;
+            }
+        }
+    }
+    return 0;
+}
+
+// Flat stack bytecode for a condition expression. && and || compile to conditional jumps,
+// so they short-circuit like the tree does. run() uses a fixed-size stack and never
+// allocates; compile() rejects expressions that would need more than MAX_DEPTH slots.
+class ConditionProgram {
+public:
+    enum class Op : std::uint8_t {
+        Push,         // arg as a signed value
+        Flag,         // arg is the flag's Symbol
+        Stat,
+        Items,
+        Not,
+        Bool,         // Top becomes 0 or 1
+        Eq, Ne, Lt, Le, Gt, Ge,
+        JumpIfFalse,  // Top is 0: keep it and jump to arg. Otherwise pop it.
+        JumpIfTrue    // Top is not 0: keep it and jump to arg. Otherwise pop it.
+    };
+
+    struct Instruction {
+        Op op;
+        std::uint32_t arg;
+    };
+
+    static constexpr std::size_t MAX_DEPTH = 16;
+
+    // Compile a parsed tree; false with a message in error if it is too deep
+    static bool compile(const ExprNode& root, ConditionProgram& program, std::string& error);
+
+    // Parse and compile source (see the grammar above)
+    static bool compile(std::string_view source, ConditionProgram& program, std::string& error);
+
+    bool empty() const { return code.empty(); }
+    const std::vector<Instruction>& getCode() const { return code; }
+
+    template <typename State>
+    bool run(const State& state) const {
+        std::int32_t stack[MAX_DEPTH];
+        std::size_t top = 0;  // Values on the stack
+        const Instruction* begin = code.data();
+        const Instruction* end = begin + code.size();
+        for (const Instruction* pc = begin; pc != end;) {
+            const Instruction in = *pc++;
+            switch (in.op) {
+                case Op::Push: stack[top++] = static_cast<std::int32_t>(in.arg); break;
+                case Op::Flag: stack[top++] = state.flag(in.arg) ? 1 : 0; break;
+                case Op::Stat: stack[top++] = state.stat(in.arg); break;
+                case Op::Items: stack[top++] = state.items(in.arg); break;
+                case Op::Not: stack[top - 1] = stack[top - 1] == 0; break;
+                case Op::Bool: stack[top - 1] = stack[top - 1] != 0; break;
+                case Op::Eq: --top; stack[top - 1] = stack[top - 1] == stack[top]; break;
+                case Op::Ne: --top; stack[top - 1] = stack[top - 1] != stack[top]; break;
+                case Op::Lt: --top; stack[top - 1] = stack[top - 1] < stack[top]; break;
+                case Op::Le: --top; stack[top - 1] = stack[top - 1] <= stack[top]; break;
+                case Op::Gt: --top; stack[top - 1] = stack[top - 1] > stack[top]; break;
+                case Op::Ge: --top; stack[top - 1] = stack[top - 1] >= stack[top]; break;
+                case Op::JumpIfFalse:
+                    if (stack[top - 1] == 0) pc = begin + in.arg;
+                    else --top;
+                    break;
+                case Op::JumpIfTrue:
+                    if (stack[top - 1] != 0) pc = begin + in.arg;
+                    else --top;
+                    break;
+            }
+        }
+        return top > 0 && stack[top - 1] != 0;
+    }
+
+private:
+    std::vector<Instruction> code;
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include "ImageScaling.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// On-disk cache of decoded RGBA pixels so warm starts skip JPEG/PNG decoding. Each entry is
+// one file holding a small header and the raw pixels, mapped on load so the pixels can go
+// straight to sf::Texture::update. Entries are keyed by asset path and size limit, and are
+// only used while the source still matches: same size, and the same stamp (or, for sources
+// without one, the same content hash). Warm hits only read the cached pixels.
+//
+// Opt-in (see ResourceManager::enableDecodedCache). Safe to use from several threads.
+class DecodedImageCache {
+public:
+    static constexpr const char* DEFAULT_DIRECTORY = "cache/decoded";
+
+    // The encoded file the pixels were decoded from
+    struct Source {
+        std::string path;                    // Asset path, also the cache key
+        const std::uint8_t* data = nullptr;  // Encoded bytes if already in memory (e.g. from the pack)
+        std::size_t size = 0;
+        std::int64_t stamp = 0;              // Mtime of a loose file or AssetPack::entryStamp; 0 means
+                                             // "compare the hash"
+    };
+
+    // Pixels of a cache hit; valid while the entry is alive
+    class Entry {
+    public:
+        std::uint32_t width() const { return size.width; }
+        std::uint32_t height() const { return size.height; }
+        const std::uint8_t* pixels() const { return file.data() + pixelOffset; }
+
+    private:
+        friend class DecodedImageCache;
+        MappedFile file;
+        ImageScaling::Size size;
+        std::size_t pixelOffset = 0;
+    };
+
+    explicit DecodedImageCache(std::string directory = DEFAULT_DIRECTORY);
+
+    // Describe a loose file (size and mtime as the stamp; its bytes are only read if the hash is needed)
+    static Source describeFile(const std::string& path);
+
+    // Cached pixels for source decoded to fit maxSize (0x0 = full size), or nullptr on a miss
+    std::unique_ptr<Entry> load(const Source& source, ImageScaling::Size maxSize = {}) const;
+
+    // Write an entry (temp file + rename, so readers never see a partial one)
+    bool store(const Source& source, ImageScaling::Size maxSize, const std::uint8_t* rgba, ImageScaling::Size size) const;
+
+    const std::string& getDirectory() const { return directory; }
+
+private:
+    std::string entryPath(const std::string& assetPath, ImageScaling::Size maxSize) const;
+
+    std::string directory;
+};
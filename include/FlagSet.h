@@ -0,0 +1,63 @@
+#pragma once
+#include "SymbolTable.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// One word of a compiled condition: passes when (flags word & mask) == expected
+struct FlagTerm {
+    std::uint32_t word = 0;
+    std::uint64_t mask = 0;
+    std::uint64_t expected = 0;
+};
+
+// A condition over flags reduced to the words it tests. Built once when a script is loaded;
+// checking it is a couple of AND/compares with no hashing or allocation.
+struct CompiledCondition {
+    std::array<FlagTerm, 2> terms{};
+    std::uint8_t count = 0;
+
+    // Require flag to read as value (flags never set read as false)
+    void require(Symbol flag, bool value);
+};
+
+// Story flags as dense bitsets indexed by Symbol (symbol ids are dense, see SymbolTable).
+// Tracks which flags were ever set as well as their values, so saves keep explicit falses.
+class FlagSet {
+public:
+    static constexpr std::size_t WORD_BITS = 64;
+
+    bool get(Symbol flag) const { return test(values, flag); }
+    bool contains(Symbol flag) const { return test(known, flag); }
+    void set(Symbol flag, bool value);
+    void clear();
+
+    // Number of flags ever set
+    std::size_t size() const { return count; }
+
+    bool matches(const CompiledCondition& condition) const {
+        for (std::uint8_t i = 0; i < condition.count; ++i) {
+            const FlagTerm& term = condition.terms[i];
+            std::uint64_t word = term.word < values.size() ? values[term.word] : 0;
+            if ((word & term.mask) != term.expected) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Every flag ever set, in symbol order
+    void forEach(const std::function<void(Symbol flag, bool value)>& visit) const;
+
+private:
+    static bool test(const std::vector<std::uint64_t>& bits, Symbol flag) {
+        std::size_t word = flag / WORD_BITS;
+        return flag != NO_SYMBOL && word < bits.size() && ((bits[word] >> (flag % WORD_BITS)) & 1);
+    }
+
+    std::vector<std::uint64_t> values;  // Current value per flag
+    std::vector<std::uint64_t> known;   // Set at least once
+    std::size_t count = 0;
+};
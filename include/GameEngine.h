@@ -3,6 +3,7 @@
 #pragma once
 #include "GameState.h"
 #include "ResourceManager.h"
+#include "ItemRegistry.h"
 #include "CustomWindow.h"
 #include <memory>
 #include <stack>
@@ -10,7 +11,9 @@
 
 class GameEngine {
 public:
-    GameEngine();
+    // reportStartup prints the per-asset startup breakdown and the time to the first frame;
+    // decodedCache keeps decoded image pixels on disk so later launches skip decoding
+    explicit GameEngine(bool reportStartup = false, bool decodedCache = false, bool journalSaves = false);
     void run();
     
     void pushState(std::unique_ptr<GameState> state);
@@ -24,7 +27,7 @@ public:
     std::unique_ptr<GameState> createMainMenuState();
     std::unique_ptr<GameState> createStartState();
     std::unique_ptr<GameState> createSettingsState();
-    std::unique_ptr<GameState> createPlayingState(const std::string& scriptPath);
+    std::unique_ptr<GameState> createPlayingState(const std::string& scriptPath, int saveSlot = 0);
     
 private:
     void processEvents();
@@ -33,7 +36,11 @@ private:
     void setupStateCallbacks(GameState* state);
     
     ResourceManager resources;
+    ItemRegistry itemRegistry{resources};  // Outlives every playthrough
     std::unique_ptr<CustomWindow> window;
     std::stack<std::unique_ptr<GameState>> stateStack;
     sf::Clock clock;
+    sf::Clock startupClock;
+    bool reportStartup = false;
+    bool firstFrameShown = false;
 };
\ No newline at end of file
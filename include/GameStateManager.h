@@ -1,33 +1,74 @@
 #pragma once
+#include "FlagSet.h"
+#include "InventorySystem.h"
+#include "ScriptParser.h"
+#include "SymbolTable.h"
+#include "SaveSlots.h"
 #include <string>
 #include <unordered_map>
 #include <nlohmann/json.hpp>
 
-struct Condition;
-struct Effects;
-class InventorySystem;  // Forward declaration
+// What one applyEffects call changed, so the save journal and whatever shows or depends on
+// game state can react to exactly that instead of comparing whole states
+struct EffectChanges {
+    std::vector<std::pair<Symbol, bool>> flags;  // New value of each flag that changed
+    std::vector<std::pair<Symbol, int>> stats;   // Net change of each stat whose value changed
+    std::vector<InventoryChange> items;          // Inventory calls that changed something, in order
+    
+    bool empty() const { return flags.empty() && stats.empty() && items.empty(); }
+};
 
 // Manages game state: flags, stats, saves
 class GameStateManager {
 public:
-    GameStateManager();
+    // In journal mode, a full snapshot replaces the journal after this many records
+    static constexpr int JOURNAL_COMPACT_EVERY = 256;
+    
+    // Saves and loads go to this save slot (see SaveSlots)
+    explicit GameStateManager(int slot = 0);
     
-    // Check if a condition is met based on current flags
-    bool checkCondition(const Condition& condition) const;
+    // Check if a condition is met: its flag terms (see FlagSet), then its expression if it
+    // has one. items() in expressions reads inventory and is 0 without one.
+    bool checkCondition(const Condition& condition, const InventorySystem* inventory = nullptr) const;
     
-    // Apply effects to flags, stats, and inventory
-    void applyEffects(const Effects& effects, InventorySystem* inventory);
+    // Apply a scene's effect steps to flags, stats and inventory as one batch, returning its
+    // change set: flag and inventory changes made meanwhile (item flag bindings included) are
+    // collected and journaled together once every step has run. Not all-or-nothing: item
+    // steps that fail are skipped and the rest still apply.
+    EffectChanges applyEffects(const Effects& effects, InventorySystem* inventory);
     
-    // Save current game state to file
+    // Queue the current game state to be saved in the background (see SaveWriter). In journal
+    // mode this appends the changes since the last save instead, except that the first save
+    // of a session and every JOURNAL_COMPACT_EVERY records write a full snapshot.
     void saveGame(const std::string& scriptId, const std::string& sceneId, 
                   const InventorySystem* inventory = nullptr);
     
-    // Load game state from file
-    void loadGame(InventorySystem* inventory = nullptr);
+    // On exit: fold the journal into a snapshot if it has grown since the last one, and
+    // record the final playtime in the slot index
+    void compactSave(const InventorySystem* inventory);
+    
+    // Title and chapter of the running script, shown for this slot in the menu
+    void setScriptDetails(const std::string& title, int chapter);
+    
+    // Time played in this slot, carried over from the slot index when loading
+    void addPlaytime(float seconds) { playtime += seconds; }
+    double getPlaytime() const { return playtime; }
+    int getSlot() const { return slot; }
     
-    // Get current flags and stats
-    const std::unordered_map<std::string, bool>& getFlags() const { return flags; }
-    const std::unordered_map<std::string, int>& getStats() const { return stats; }
+    // Journal an inventory change (hooked to InventorySystem::setOnChanged); during
+    // applyEffects it joins the batch's change set instead
+    void recordInventoryChange(const InventoryChange& change);
+    
+    // Copy of everything a save holds
+    SaveState snapshot(const InventorySystem* inventory) const;
+    
+    // Load game state from file (both parse modes produce identical state), then replay
+    // the journal written since that snapshot, if any
+    void loadGame(InventorySystem* inventory = nullptr, JsonParseMode mode = JsonParseMode::Streaming);
+    
+    // Get current flags and stats, keyed by interned name
+    const FlagSet& getFlags() const { return flags; }
+    const std::unordered_map<Symbol, int>& getStats() const { return stats; }
     
     // Get current script/scene location
     std::string getCurrentScript() const { return currentScript; }
@@ -37,12 +78,44 @@ public:
     // Reset save data to beginning
     void clearSave();
     
-    // Manually set a flag
-    void setFlag(const std::string& flag, bool value) { flags[flag] = value; }
+    // Manually set a flag; setting a flag to the value it already has changes nothing
+    void setFlag(Symbol flag, bool value);
+    void setFlag(const std::string& flag, bool value) { setFlag(intern(flag), value); }
 
 private:
-    std::unordered_map<std::string, bool> flags;     // Story flags (true/false)
-    std::unordered_map<std::string, int> stats;      // Numeric stats
+    // Apply a save's contents (JSON text or CBOR); false if it did not parse
+    bool loadGameDom(const std::uint8_t* data, std::size_t size, nlohmann::json::input_format_t format,
+                     InventorySystem* inventory);
+    bool loadGameStreaming(const std::uint8_t* data, std::size_t size, nlohmann::json::input_format_t format,
+                           InventorySystem* inventory);
+    
+    // Apply the journal at path if it extends the snapshot with this checksum
+    void replayJournal(const std::string& path, std::uint32_t baseChecksum, InventorySystem* inventory);
+    
+    // Queue a record for the next save (journal mode only)
+    void record(const JournalRecord& record);
+    
+    // Write a full snapshot and start a new journal
+    void submitSnapshot(const InventorySystem* inventory);
+    
+    // Refresh this slot's index entry
+    void updateSlotInfo();
+    
+    SaveWriter& writer() { return SaveSlots::global().writer(slot); }
+    
+    FlagSet flags;                              // Story flags (true/false)
+    std::unordered_map<Symbol, int> stats;      // Numeric stats
     std::string currentScript;                        // Current story script
     std::string currentScene;                         // Current scene within script
+    
+    int slot = 0;
+    std::string scriptTitle;
+    int chapter = 0;
+    double playtime = 0;                 // Seconds
+    
+    std::vector<std::uint8_t> journal;   // Records since the last save
+    int journalEntries = 0;              // Records since the last snapshot
+    bool snapshotWritten = false;        // This session has a snapshot for the journal to extend
+    bool replaying = false;              // Applying the journal; nothing to record
+    EffectChanges* pendingChanges = nullptr;  // Change set of the applyEffects call in progress, if any
 };
\ No newline at end of file
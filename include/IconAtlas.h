@@ -0,0 +1,46 @@
+#pragma once
+#include "SymbolTable.h"
+#include <SFML/Graphics.hpp>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// All item icons packed into one texture, so the inventory grid (icons and cell
+// backgrounds) draws as a single vertex array with a single texture bind.
+// Icons are stored at no more than ICON_SIZE x ICON_SIZE, centred in fixed slots.
+// Slots are laid out up front; pixels arrive one icon at a time as they are first shown.
+class IconAtlas {
+public:
+    static constexpr unsigned ICON_SIZE = 128;  // Largest a grid cell is drawn in practice
+    static constexpr unsigned MAX_SIZE = 4096;  // Single page; supported by any GPU we target
+
+    // Lay out a slot for each id, dropping any uploaded icons. Ids that do not fit on the
+    // page are logged and get no slot.
+    void reset(const std::vector<Symbol>& ids);
+
+    // Copy an icon (already fitted to ICON_SIZE) into its slot. The texture is created on
+    // the first upload.
+    bool upload(Symbol id, const sf::Image& icon);
+
+    bool hasSlot(Symbol id) const { return slots.count(id) > 0; }
+
+    // nullptr until the first icon is uploaded
+    const sf::Texture* getTexture() const { return texture ? &*texture : nullptr; }
+
+    // Texture rect of an uploaded icon's pixels, or nullptr
+    const sf::IntRect* getRect(Symbol id) const;
+
+    // Texture coordinate inside an opaque white block, for untextured (vertex-coloured) quads
+    sf::Vector2f getWhiteTexel() const { return {WHITE_SIZE / 2.f, WHITE_SIZE / 2.f}; }
+
+private:
+    static constexpr unsigned WHITE_SIZE = 4;
+    static constexpr unsigned GAP = 2;  // Transparent gutter so smoothing never samples a neighbour
+
+    bool createTexture();
+
+    sf::Vector2u pageSize;
+    std::optional<sf::Texture> texture;
+    std::unordered_map<Symbol, sf::Vector2u> slots;  // Top-left corner of each slot
+    std::unordered_map<Symbol, sf::IntRect> rects;
+};
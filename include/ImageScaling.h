@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// CPU image resampling for RGBA8 pixel buffers (no SFML dependency, safe on worker threads)
+namespace ImageScaling {
+
+struct Size {
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+};
+
+// Largest size with the source aspect ratio that fits in maxSize; never upscales.
+// A zero maxSize (either side) means no limit.
+Size fitWithin(Size source, Size maxSize);
+
+// Box-filter downscale: every destination pixel averages the source pixels it covers.
+// Returns the source unchanged (copied) if target is not smaller.
+std::vector<std::uint8_t> downscaleBox(const std::uint8_t* rgba, Size source, Size target);
+
+} // namespace ImageScaling
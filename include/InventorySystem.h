@@ -2,62 +2,75 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <functional>
 #include <nlohmann/json.hpp>
-#include "ResourceManager.h"
+#include "ItemRegistry.h"
+#include "ItemStacks.h"
+#include "SymbolTable.h"
 
-class GameStateManager;
-
-// Template/blueprint for items - defines properties shared by all instances of an item type
-struct ItemDefinition {
-    std::string id;
-    std::string name;
-    std::string description;
-    std::string texturePath;
-    bool stackable = true;
-    int maxStackSize = 99;
+// One successful call that changed the inventory; replaying the same calls in order
+// reproduces the same stacks (used by the save journal)
+struct InventoryChange {
+    enum class Kind { Add, Remove, RemoveAt };
+    Kind kind;
+    Symbol itemId = NO_SYMBOL;  // Add, Remove
+    int index = -1;             // RemoveAt
+    int quantity = 0;           // Amount actually added or removed
 };
 
-// Actual item instance in inventory - references a definition and has a quantity
-struct InventoryItem {
-    std::string id;
-    int quantity = 1;
-    
-    InventoryItem(const std::string& id, int quantity = 1) 
-        : id(id), quantity(quantity) {}
-};
-
-// Manages inventory: loading item definitions, adding/removing items, and save/load
+// Manages inventory contents: adding/removing items and save/load. Item definitions come
+// from the shared registry, which is loaded on first use.
 class InventorySystem {
 public:
-    InventorySystem(ResourceManager& resources);
+    // Called when an item's total goes from zero to held (true) or back to zero (false)
+    using HeldChangedCallback = std::function<void(const ItemDefinition& item, bool held)>;
+    using ChangedCallback = std::function<void(const InventoryChange& change)>;
+    
+    InventorySystem(ItemRegistry& registry);
     
     // Add items to inventory (stacks if possible)
-    bool addItem(const std::string& itemId, int quantity = 1);
+    bool addItem(Symbol itemId, int quantity = 1);
     
-    // Remove items from inventory and optionally update game state flags
-    bool removeItem(const std::string& itemId, int quantity = 1, GameStateManager* gameState = nullptr);
+    // Remove items from inventory
+    bool removeItem(Symbol itemId, int quantity = 1);
     
     // Check if inventory contains at least one of an item
-    bool hasItem(const std::string& itemId) const;
+    bool hasItem(Symbol itemId) const { return items.contains(itemId); }
     
     // Get total quantity of an item across all stacks
-    int getItemCount(const std::string& itemId) const;
+    int getItemCount(Symbol itemId) const { return items.count(itemId); }
     
-    const std::vector<InventoryItem>& getItems() const { return items; }
-    const ItemDefinition* getItemDefinition(const std::string& itemId) const;
+    // Stacks in grid order
+    const std::vector<InventoryItem>& getItems() const { return items.getStacks(); }
+    const ItemDefinition* getItemDefinition(Symbol itemId) const;
+    
+    const ItemRegistry& getRegistry() const { return registry; }
     
     // Remove item at specific grid position
-    void removeItemAtIndex(int index, int quantity = 1, GameStateManager* gameState = nullptr);
+    void removeItemAtIndex(int index, int quantity = 1);
+    
+    // True if any held item declares the flag in items.json
+    bool holdsItemWithFlag(Symbol flag) const;
+    
+    // Restoring a save does not notify; the saved flags already match the saved items
+    void setOnHeldChanged(HeldChangedCallback callback) { onHeldChanged = std::move(callback); }
+    
+    // Called after every add/remove that changed something; restoring a save does not notify
+    void setOnChanged(ChangedCallback callback) { onChanged = std::move(callback); }
     
     // Serialize/deserialize inventory for save system
     void saveToJson(nlohmann::json& saveData) const;
     void loadFromJson(const nlohmann::json& saveData);
     
+    // Replace inventory contents with (item id, quantity) entries, skipping unknown items
+    void loadFromEntries(const std::vector<std::pair<std::string, int>>& entries);
+    
 private:
-    // Load item definitions from JSON file
-    bool loadItemDefinitions();
+    void notifyHeldChanged(Symbol itemId, bool held);
+    void notifyChanged(const InventoryChange& change);
     
-    ResourceManager& resources;
-    std::vector<InventoryItem> items;  // Actual inventory contents
-    std::unordered_map<std::string, ItemDefinition> itemDefinitions;  // Item templates
+    const ItemRegistry& registry;
+    HeldChangedCallback onHeldChanged;
+    ChangedCallback onChanged;
+    ItemStacks items;  // Actual inventory contents
 };
\ No newline at end of file
@@ -36,23 +36,24 @@ public:
     // Update hover state and tooltip
     void update(const sf::Vector2i& mousePos, const InventorySystem& inventory);
     
-    // Render grid, items, and tooltip
+    // Render grid and items (one draw call through the icon atlas), then the tooltip
     void draw(sf::RenderWindow& window, const InventorySystem& inventory);
     
 private:
     // Single cell in the inventory grid
     struct GridCell {
         sf::FloatRect bounds;
-        sf::RectangleShape background;
     };
     
     void createGrid(const sf::FloatRect& containerBounds, float padding);
     int getCellAtPosition(const sf::Vector2f& pos) const;
     void updateScroll(float delta, int totalItems);
+    void appendQuad(const sf::FloatRect& bounds, const sf::FloatRect& texture, sf::Color color);
     int getMaxScroll(int totalItems) const;
     
     ResourceManager& resources;
     std::vector<GridCell> grid;
+    sf::VertexArray gridVertices{sf::PrimitiveType::Triangles};  // Rebuilt every frame
     
     int hoveredCell = -1;
     int scrollOffset = 0;  // How many rows have been scrolled
@@ -0,0 +1,62 @@
+#pragma once
+#include "IconAtlas.h"
+#include "SymbolTable.h"
+#include <SFML/Graphics.hpp>
+#include <future>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class ResourceManager;
+
+// Template/blueprint for items - defines properties shared by all instances of an item type
+struct ItemDefinition {
+    Symbol id = NO_SYMBOL;
+    std::string name;
+    std::string description;
+    std::string texturePath;
+    std::vector<Symbol> flags;  // Set while the item is held, cleared once none are left
+    bool stackable = true;
+    int maxStackSize = 99;
+};
+
+// Item definitions from items.json, read once and shared by every playthrough (the
+// engine owns one). Icons are decoded in the background the first time an item is
+// shown and kept in the atlas, so starting a new game costs no item I/O.
+class ItemRegistry {
+public:
+    explicit ItemRegistry(ResourceManager& resources);
+    ~ItemRegistry();
+
+    ItemRegistry(const ItemRegistry&) = delete;
+    ItemRegistry& operator=(const ItemRegistry&) = delete;
+
+    // Read items.json unless already loaded; a failed read is retried on the next call
+    bool load();
+    bool isLoaded() const { return loaded; }
+
+    const ItemDefinition* find(Symbol itemId) const;
+    const std::unordered_map<Symbol, ItemDefinition>& getDefinitions() const { return definitions; }
+    
+    // Items that declare flag in their "flags" list
+    const std::vector<Symbol>& getItemsWithFlag(Symbol flag) const;
+
+    // Atlas rect of an item's icon. The first request starts decoding it; nullptr until it
+    // has been uploaded (or if the item has no icon). Main thread only.
+    const sf::IntRect* getIcon(Symbol itemId) const;
+
+    const IconAtlas& getIconAtlas() const { return iconAtlas; }
+
+private:
+    ResourceManager& resources;
+    bool loaded = false;
+    std::unordered_map<Symbol, ItemDefinition> definitions;
+    std::unordered_map<Symbol, std::vector<Symbol>> flagItems;  // Flag -> items deriving it
+
+    // Filled in as icons are first shown
+    mutable IconAtlas iconAtlas;
+    mutable std::unordered_map<Symbol, std::future<std::optional<sf::Image>>> pendingIcons;
+    mutable std::unordered_set<Symbol> missingIcons;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include "SymbolTable.h"
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+// Actual item instance in inventory - references a definition and has a quantity
+struct InventoryItem {
+    Symbol id = NO_SYMBOL;
+    int quantity = 1;
+    
+    InventoryItem(Symbol id, int quantity = 1) 
+        : id(id), quantity(quantity) {}
+};
+
+// Inventory stacks in slot order (what the grid shows), with a per-item index of totals
+// and stack positions kept up to date on every change. Counts and presence checks are
+// O(1); adding only visits the item's own stacks. Removing a stack keeps the remaining
+// order, so it shifts the later slots in one pass.
+class ItemStacks {
+public:
+    // Top up the item's existing stacks in slot order (if stackable), then append new ones
+    void add(Symbol id, int quantity, int maxStackSize, bool stackable);
+    
+    // Take up to quantity from the item's stacks in slot order; returns how many were taken
+    int remove(Symbol id, int quantity);
+    
+    // Take up to quantity from the stack at index; returns its item (NO_SYMBOL if out of range)
+    Symbol removeAt(std::size_t index, int quantity);
+    
+    // Append a stack as-is, without merging (restoring a saved inventory)
+    void append(Symbol id, int quantity);
+    
+    void clear();
+    
+    bool contains(Symbol id) const { return index.count(id) > 0; }
+    int count(Symbol id) const;
+    
+    const std::vector<InventoryItem>& getStacks() const { return stacks; }
+    
+private:
+    struct Entry {
+        int total = 0;
+        std::vector<std::size_t> positions;  // Ascending slots holding this item
+    };
+    
+    // Drop the stacks at the given ascending positions, then fix up every moved position
+    void erase(const std::vector<std::size_t>& removed);
+    
+    std::vector<InventoryItem> stacks;
+    std::unordered_map<Symbol, Entry> index;  // Only items with at least one stack
+};
@@ -7,9 +7,10 @@
 #include "Button.h"
 #include "ResourceManager.h"
 #include <memory>
+#include <vector>
 #include <SFML/Graphics.hpp>
 
-// Main menu screen with buttons and fade-to-black transition
+// Main menu screen with buttons, the save slot list and fade-to-black transition
 class MainMenuState : public GameState
 {
 public:
@@ -20,17 +21,20 @@ public:
     void draw(sf::RenderWindow& window) override;
     GameStateType getType() const override { return GameStateType::MainMenu; }
     
-    // Register callbacks for button clicks
-    void setOnStartClicked(std::function<void()> callback);
+    // Register callbacks for button clicks; start receives the selected save slot
+    void setOnStartClicked(std::function<void(int saveSlot)> callback);
     void setOnSettingsClicked(std::function<void()> callback);
     
     // Recalculate positions when window resizes
     void updatePositions(const sf::Vector2u& windowSize) override;
     
-    // Reset fade effect when returning to menu
+    // Reset fade effect when returning to menu (and show the slots as saved since)
     void resetTransition();
     
 private:
+    // Relabel the slot buttons from the save index
+    void refreshSlots();
+    
     ResourceManager& resources;
     sf::Sprite backgroundSprite;
     sf::Sprite logoSprite;
@@ -38,8 +42,10 @@ private:
     
     std::unique_ptr<Button> startButton;
     std::unique_ptr<Button> settingsButton;
+    std::vector<std::unique_ptr<Button>> slotButtons;
+    int selectedSlot = 0;
     
-    std::function<void()> onStartClicked;
+    std::function<void(int saveSlot)> onStartClicked;
     std::function<void()> onSettingsClicked;
     
     // Transition system
@@ -13,7 +13,12 @@
 // Main gameplay state - manages scenes, choices, inventory, and transitions
 class PlayingState : public GameState {
 public:
-    PlayingState(ResourceManager& resources, const std::string& scriptPath);
+    // Continues or starts the story in the given save slot
+    PlayingState(ResourceManager& resources, ItemRegistry& itemRegistry, const std::string& scriptPath,
+                 int saveSlot = 0);
+    
+    // Folds any save journal into a snapshot
+    ~PlayingState() override;
     
     void handleEvent(const sf::Event& event) override;
     void update(float deltaTime, sf::RenderWindow& window) override;
@@ -26,9 +31,11 @@ public:
     GameStateManager& getGameStateManager() { return *gameState; }
     
 private:
-    void loadScene(const std::string& sceneId);
+    void loadScene(std::uint32_t sceneIndex);
+    void saveProgress();
     void createChoiceButtons();
-    void startTransition(const std::string& sceneId);
+    void startTransition(std::uint32_t sceneIndex);
+    void takeChoice(const Choice& choice);
     void updateTransition(float deltaTime);
     
     // Fade transition states between scenes
@@ -56,7 +63,7 @@ private:
     // Scene transition system
     TransitionState transitionState = TransitionState::None;
     float transitionAlpha = 0.f;
-    std::string nextSceneId;
+    std::uint32_t nextSceneIndex = SCENE_NONE;
     sf::RectangleShape transitionOverlay;
     const float transitionDuration = 0.25f;
     
@@ -34,6 +34,9 @@ public:
     // Get current window size
     const sf::Vector2u& getWindowSize() const { return windowSize; }
     
+    // Size of the box the scene background is drawn into
+    sf::Vector2f getGraphicsBoxSize() const { return graphicsBox.getSize(); }
+    
     // Set the inventory system reference
     void setInventorySystem(InventorySystem* inventory);
     
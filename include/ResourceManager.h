@@ -1,30 +1,135 @@
 // SFML 3.x
 
 #pragma once
+#include "AssetManifest.h"
+#include "AssetPack.h"
+#include "DecodedImageCache.h"
+#include "SymbolTable.h"
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include <cstddef>
+#include <list>
+#include <memory>
 #include <unordered_map>
 #include <string>
 
-// Centralized manager for loading and accessing game resources
+// Shared reference to a cached texture; the texture cannot be evicted while a handle exists
+using TextureHandle = std::shared_ptr<const sf::Texture>;
+
+// Texture cache counters (hits/misses count acquireTexture lookups)
+struct TextureCacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+    std::size_t textureCount = 0;
+    std::size_t residentBytes = 0;
+    std::size_t budgetBytes = 0;
+};
+
+// Centralized manager for loading and accessing game resources.
+// Resources are keyed by interned id; the string overloads intern/look up the id first.
+//
+// Textures live in an LRU cache with a byte budget (RGBA size). Least recently used textures
+// are evicted once the budget is exceeded, except pinned ones: those with a live TextureHandle
+// and those ever handed out by reference through getTexture, which stay resident for good.
+//
+// With an asset pack mounted, every load looks the path up in the pack first and decodes
+// straight from the mapping; paths the pack does not have are read from loose files.
 class ResourceManager
 {
 public:
+    static constexpr std::size_t DEFAULT_TEXTURE_BUDGET = 128 * 1024 * 1024;
+    
+    // Map an asset pack; returns false (and keeps using loose files) if it is missing or invalid
+    bool mountPack(const std::string& path);
+    const AssetPack& getPack() const { return pack; }
+    
+    // Load the asset manifest from the pack, then assets/manifest.json, else scan assets/
+    bool loadManifest();
+    const AssetManifest& getManifest() const { return manifest; }
+    
+    // Decoded size of the texture at path per the manifest (0 if it is not listed)
+    std::size_t expectedTextureBytes(const std::string& path) const;
+    
+    // Keep decoded RGBA pixels on disk so later runs skip image decoding (off by default).
+    // Call before loading anything; the cache is shared by every image and texture load.
+    void enableDecodedCache(const std::string& directory = DecodedImageCache::DEFAULT_DIRECTORY);
+    
+    // Decode from the pack or a loose file without storing anything. These only read the
+    // pack, so worker threads may call them while the main thread uses the manager.
+    // A non-zero maxSize downscales the image to fit (and caches that variant separately).
+    bool decodeImage(sf::Image& image, const std::string& path, sf::Vector2u maxSize = {}) const;
+    bool decodeFont(sf::Font& font, const std::string& path) const;
+    bool decodeSoundBuffer(sf::SoundBuffer& buffer, const std::string& path) const;
+    
     // Load resources from file paths
     bool loadTexture(const std::string& id, const std::string& path);
+    bool loadTexture(Symbol id, const std::string& path);
     bool loadFont(const std::string& id, const std::string& path);
     bool loadMusic(const std::string& id, const std::string& path);
     bool loadSoundBuffer(const std::string& id, const std::string& path);
     
-    // Get loaded resources by ID
+    // Store resources decoded elsewhere (see AssetLoader); the texture upload happens here
+    bool addTexture(Symbol id, const sf::Image& image);
+    TextureHandle uploadTexture(Symbol id, const sf::Image& image);
+    void addFont(Symbol id, sf::Font&& font);
+    void addSoundBuffer(Symbol id, sf::SoundBuffer&& buffer);
+    
+    // Get loaded resources by ID (textures returned by reference are pinned permanently)
     sf::Texture& getTexture(const std::string& id);
+    sf::Texture& getTexture(Symbol id);
+    
+    // Handle to a cached texture, or nullptr on a miss (the caller then loads it)
+    TextureHandle acquireTexture(Symbol id);
     sf::Font& getFont(const std::string& id);
+    sf::Font& getFont(Symbol id);
     sf::Music& getMusic(const std::string& id);
     sf::SoundBuffer& getSoundBuffer(const std::string& id);
+    
+    bool hasTexture(Symbol id) const { return textures.count(id) != 0; }
+    
+    // Size of a cached texture without touching its LRU position (0x0 if not loaded)
+    sf::Vector2u getTextureSize(Symbol id) const;
+    
+    // Change the texture budget, evicting right away if the cache is now over it
+    void setTextureBudget(std::size_t bytes);
+    TextureCacheStats getTextureStats() const;
 
 private:
-    std::unordered_map<std::string, sf::Texture> textures;
-    std::unordered_map<std::string, sf::Font> fonts;
-    std::unordered_map<std::string, std::unique_ptr<sf::Music>> music;  // Unique ptr since Music is non-copyable
-    std::unordered_map<std::string, sf::SoundBuffer> soundBuffers;
-};
\ No newline at end of file
+    struct TextureEntry {
+        std::shared_ptr<sf::Texture> texture;
+        std::size_t bytes = 0;
+        bool pinned = false;  // Handed out by reference
+        std::list<Symbol>::iterator lruPosition;
+    };
+    
+    // Insert or replace a texture (in place, so outstanding references see the new one)
+    TextureHandle storeTexture(Symbol id, sf::Texture&& texture);
+    void touch(TextureEntry& entry);
+    // Decode (skipping the cache lookup), downscale to maxSize and write the cache entry
+    bool decodeAndCache(sf::Image& image, const DecodedImageCache::Source& source, sf::Vector2u maxSize) const;
+    
+    // Texture straight from the pack/file, or from mapped cache pixels when the cache is on
+    bool readTexture(sf::Texture& texture, const std::string& path) const;
+    
+    // Identity of the encoded bytes behind path, for cache validation
+    DecodedImageCache::Source describeSource(const std::string& path) const;
+    
+    // Evict until incomingBytes more would fit in the budget
+    void evictTextures(std::size_t incomingBytes = 0);
+    
+    // Declared first so it is unmapped only after the fonts and music streaming from it
+    AssetPack pack;
+    AssetManifest manifest;
+    std::unique_ptr<const DecodedImageCache> decodedCache;
+    std::unordered_map<Symbol, TextureEntry> textures;
+    std::list<Symbol> textureLru;  // Most recently used first
+    std::size_t textureBytes = 0;
+    std::size_t textureBudget = DEFAULT_TEXTURE_BUDGET;
+    std::size_t textureHits = 0;
+    std::size_t textureMisses = 0;
+    std::size_t textureEvictions = 0;
+    std::unordered_map<Symbol, sf::Font> fonts;
+    std::unordered_map<Symbol, std::unique_ptr<sf::Music>> music;  // Unique ptr since Music is non-copyable
+    std::unordered_map<Symbol, sf::SoundBuffer> soundBuffers;
+};
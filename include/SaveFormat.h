@@ -0,0 +1,126 @@
+#pragma once
+#include "ItemStacks.h"
+#include "SymbolTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Everything a save file holds, copied out of the live game state so it can be written
+// on another thread while play continues
+struct SaveState {
+    std::string currentScript;
+    std::string currentScene;
+    std::vector<std::pair<Symbol, bool>> flags;
+    std::vector<std::pair<Symbol, int>> stats;
+    std::vector<InventoryItem> inventory;
+};
+
+// One change since the last snapshot, as appended to the save journal
+struct JournalRecord {
+    enum class Type : std::uint8_t {
+        SetFlag = 1,    // key = value != 0
+        AddStat,        // key += value
+        AddItem,        // InventorySystem::addItem(key, value)
+        RemoveItem,     // InventorySystem::removeItem(key, value)
+        RemoveItemAt,   // InventorySystem::removeItemAtIndex(index, value)
+        Location        // currentScript/currentScene = script/scene
+    };
+    
+    Type type = Type::SetFlag;
+    Symbol key = NO_SYMBOL;
+    std::int32_t value = 0;
+    std::int32_t index = 0;
+    std::string script;
+    std::string scene;
+};
+
+// On-disk layout of binary saves (.uasv), written by SaveWriter and read by GameStateManager.
+// All header fields are 32-bit little-endian values.
+//
+//   SaveHeader
+//   payload                      the save's JSON layout (see SaveWriter::toJson) as CBOR
+//
+// The checksum is FNV-1a over the payload, so truncated or corrupted saves are rejected
+// instead of half-loaded. Saves from before this format were indented JSON text; see saveconv.
+//
+// In journal mode (SaveWriter::setJournaling) each transition instead appends a few records
+// to a journal (.uasj) next to the save, and loading replays it on top of the snapshot:
+//
+//   JournalHeader                baseChecksum = checksum of the snapshot it extends
+//   record*                      u8 type, u16 size, size payload bytes, u32 FNV-1a of all three
+//
+// Payload strings are a u16 length plus bytes. A journal whose base does not match the
+// snapshot predates it (the snapshot already holds its changes) and is ignored; a torn
+// record at the end, from a crash mid-append, ends the replay.
+namespace SaveFormat {
+
+constexpr char kMagic[4] = {'U', 'A', 'S', 'V'};
+constexpr std::uint32_t kVersion = 1;
+constexpr const char* kExtension = ".uasv";
+constexpr char kIndexMagic[4] = {'U', 'A', 'S', 'I'};
+constexpr std::uint32_t kIndexVersion = 1;
+
+// Single-save layout from before save slots; the first slot takes it over
+constexpr const char* kLegacyBinaryPath = "assets/save_data.uasv";
+constexpr const char* kLegacyJournalPath = "assets/save_data.uasj";
+constexpr const char* kLegacyJsonPath = "assets/save_data.json";
+
+constexpr char kJournalMagic[4] = {'U', 'A', 'S', 'J'};
+constexpr std::uint32_t kJournalVersion = 1;
+
+struct SaveHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t payloadSize;
+    std::uint32_t checksum;
+};
+
+struct JournalHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t baseChecksum;
+};
+
+// Checked slice of a binary save
+struct Payload {
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+    std::uint32_t checksum = 0;  // Identifies the snapshot to its journal
+};
+
+// Header and CBOR payload for a save. The state is encoded directly, without building a
+// document first; it decodes to exactly SaveWriter::toJson(state).
+std::vector<std::uint8_t> encode(const SaveState& state);
+
+// Same for a save already held as a document (e.g. converted from JSON)
+std::vector<std::uint8_t> encode(const nlohmann::json& save);
+
+// The save slot index (SaveSlots) uses the same header with its own magic and version
+std::vector<std::uint8_t> encodeIndex(const nlohmann::json& index);
+bool decodeIndex(const std::uint8_t* data, std::size_t size, Payload& payload, std::string& error);
+
+// True if the bytes start like a binary save (as opposed to a JSON one)
+bool isBinary(const std::uint8_t* data, std::size_t size);
+
+// Validate header, size and checksum. False with a message in error otherwise.
+bool decode(const std::uint8_t* data, std::size_t size, Payload& payload, std::string& error);
+
+// Checksum a snapshot's journal must carry; the snapshot's header checksum
+std::uint32_t snapshotChecksum(const std::vector<std::uint8_t>& encoded);
+
+// Header of an empty journal extending the snapshot with this checksum
+std::vector<std::uint8_t> journalHeader(std::uint32_t baseChecksum);
+
+// Append one framed record
+void appendRecord(std::vector<std::uint8_t>& out, const JournalRecord& record);
+
+// Records of a journal extending the snapshot with this checksum. False with a message in
+// error if the journal is unreadable or extends another snapshot. A torn or corrupt tail is
+// dropped: true with the records before it, and error describing what was dropped.
+bool readJournal(const std::uint8_t* data, std::size_t size, std::uint32_t baseChecksum,
+                 std::vector<JournalRecord>& records, std::string& error);
+
+} // namespace SaveFormat
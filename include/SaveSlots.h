@@ -0,0 +1,74 @@
+#pragma once
+#include "SaveWriter.h"
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// What the menu shows for a slot, kept in the save index so listing slots never opens a save
+struct SlotInfo {
+    bool used = false;
+    std::string scriptId;
+    std::string scriptTitle;
+    int chapter = 0;                    // ScriptMetadata::chapter
+    std::string sceneId;
+    std::uint32_t playtimeSeconds = 0;
+    std::int64_t savedAt = 0;           // Unix time of the last save
+    std::uint32_t thumbnailOffset = 0;  // Byte offset of a thumbnail image in the slot's save; 0 if none
+    std::uint32_t thumbnailSize = 0;
+};
+
+// SLOT_COUNT save slots, each with its own save and journal (one SaveWriter per slot), plus
+// one small index file describing all of them. The index is read once; updates rewrite it in
+// the background, coalesced like saves. Loading a slot opens only that slot's files.
+//
+//   assets/saves/index.uasi      SaveHeader ("UASI") + CBOR array of slot entries
+//   assets/saves/slotN.uasv      Save for slot N (1-based on disk, as shown in the menu)
+//   assets/saves/slotN.uasj      Its journal
+class SaveSlots {
+public:
+    static constexpr int SLOT_COUNT = 3;
+    static constexpr const char* DEFAULT_DIRECTORY = "assets/saves";
+
+    explicit SaveSlots(std::string directory = DEFAULT_DIRECTORY);
+
+    // Waits for every slot's saves and the index
+    ~SaveSlots();
+
+    SaveSlots(const SaveSlots&) = delete;
+    SaveSlots& operator=(const SaveSlots&) = delete;
+
+    static SaveSlots& global();
+
+    // Writer for a slot's save and journal; slot must be in [0, SLOT_COUNT)
+    SaveWriter& writer(int slot) { return *writers[slot]; }
+
+    // Copy of a slot's index entry (unused entry if out of range)
+    SlotInfo getSlot(int slot) const;
+
+    // Replace a slot's entry and queue the index to be rewritten
+    void update(int slot, SlotInfo info);
+    void clear(int slot) { update(slot, SlotInfo{}); }
+
+    // Applies to every slot's writer
+    void setJournaling(bool enabled);
+
+    // Block until all slots and the index are on disk
+    void flush();
+
+private:
+    void loadIndex();
+    void drainIndex();
+    bool writeIndex(const std::vector<SlotInfo>& entries) const;
+
+    std::string directory;
+    std::string indexPath;
+    std::vector<std::unique_ptr<SaveWriter>> writers;
+    mutable std::mutex mutex;
+    std::vector<SlotInfo> slots;
+    bool indexDirty = false;      // slots changed since the writer last copied them
+    bool draining = false;        // An index write job is queued or running
+    std::shared_future<void> drain;
+};
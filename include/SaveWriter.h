@@ -0,0 +1,71 @@
+#pragma once
+#include "SaveFormat.h"
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Writes binary saves (see SaveFormat.h) on the shared thread pool. A save submitted while
+// an earlier one is still waiting replaces it, so a burst of scene changes costs one write.
+// Each write goes to a temp file that is then renamed over the save, so a crash leaves the
+// old or the new save, never a partial one.
+//
+// With journaling on, every submitted state also starts a fresh journal, and records
+// queued with append() are added to the end of it in order.
+//
+// There is one writer per save slot; see SaveSlots.
+class SaveWriter {
+public:
+    SaveWriter(std::string path, std::string journalPath);
+    
+    // Waits for the last write
+    ~SaveWriter();
+    
+    SaveWriter(const SaveWriter&) = delete;
+    SaveWriter& operator=(const SaveWriter&) = delete;
+    
+    // Queue state to be written; returns immediately. Records appended before it are dropped,
+    // since the state already includes them.
+    void submit(SaveState state);
+    
+    // Queue encoded journal records (SaveFormat::appendRecord) to follow the last state
+    void append(std::vector<std::uint8_t> records);
+    
+    // Journal mode: saves become occasional snapshots plus appended records (GameStateManager)
+    void setJournaling(bool enabled) { journaling = enabled; }
+    bool isJournaling() const { return journaling; }
+    
+    // Block until everything submitted so far is on disk (before reading the save back)
+    void flush();
+    
+    const std::string& getPath() const { return path; }
+    const std::string& getJournalPath() const { return journalPath; }
+    
+    // The save's logical layout; stored as CBOR, and what saveconv exports for debugging
+    static nlohmann::json toJson(const SaveState& state);
+    
+    // Write bytes to path + ".tmp", then rename it over path, so readers see the old file or
+    // the new one, never a partial one. On failure, logs "Failed to <what>: ..." and returns false.
+    static bool writeFileReplacing(const std::string& path, const std::vector<std::uint8_t>& bytes,
+                                   const char* what);
+    
+private:
+    void drainPending();
+    bool write(const SaveState& state, std::uint32_t& checksum) const;
+    bool startJournal(std::uint32_t baseChecksum, const std::vector<std::uint8_t>& records) const;
+    bool appendJournal(const std::vector<std::uint8_t>& records) const;
+    
+    std::string path;
+    std::string journalPath;
+    std::atomic<bool> journaling{false};
+    std::mutex mutex;
+    std::optional<SaveState> pending;           // Newest state not yet picked up by the writer
+    std::vector<std::uint8_t> pendingRecords;   // Journal records queued after it
+    bool draining = false;                      // A drain job is queued or running
+    bool journalReady = false;                  // Journal on disk extends the last state written (drain only)
+    std::shared_future<void> drain;
+};
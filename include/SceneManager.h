@@ -4,34 +4,108 @@
 #include "ScriptParser.h"
 #include "ResourceManager.h"
 #include <SFML/Graphics.hpp>
+#include <atomic>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <functional>
+#include <future>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 // Manages game scenes and script progression
 class SceneManager {
 public:
     SceneManager(ResourceManager& resources);
     
-    // Load a game script from file
+    // Cancels background decodes and waits for any still running (they read through resources)
+    ~SceneManager();
+    
+    // Load a game script from file (through the process-wide ScriptCache)
     bool loadScript(const std::string& scriptPath);
     
     // Load and display a specific scene by ID
     bool loadScene(const std::string& sceneId);
     
+    // Load and display a scene by its resolved index (see Choice::target)
+    bool loadScene(std::uint32_t sceneIndex);
+    
+    // Size of the box backgrounds are drawn into. Backgrounds are decoded downscaled to fit it
+    // (on the thread pool), and regenerated when it changes enough to matter.
+    void setDisplaySize(sf::Vector2u boxSize);
+    
+    // Per frame: swap in a regenerated background variant once it has been decoded
+    void update();
+    
+    // Start decoding the scene's background on the thread pool (no-op if loaded or in flight)
+    void prepareScene(std::uint32_t sceneIndex);
+    
+    // True once loadScene(sceneIndex) will not have to wait for a background decode
+    bool isSceneReady(std::uint32_t sceneIndex) const;
+    
+    // Decode the backgrounds of scenes reachable from sceneIndex, nearest first, and cancel
+    // decodes that are no longer reachable. Called by loadScene; call again after flags change.
+    void prefetchFrom(std::uint32_t sceneIndex);
+    
+    // Prefetch tuning: choice hops to look ahead (0 disables) and max backgrounds kept in flight
+    void setPrefetchDepth(int depth) { prefetchDepth = depth; }
+    void setPrefetchLimit(std::size_t limit) { prefetchLimit = limit; }
+    
+    // Decides which choices are visible while prefetching (e.g. GameStateManager::checkCondition).
+    // Without a filter every choice is followed.
+    void setChoiceFilter(std::function<bool(const Condition&)> filter) { choiceFilter = std::move(filter); }
+    
     // Getters for current state
     const Scene* getCurrentScene() const { return currentScene; }
-    const GameScript& getScript() const { return script; }
+    std::uint32_t getCurrentSceneIndex() const { return currentSceneIndex; }
+    const GameScript& getScript() const { return *script; }
     std::unique_ptr<sf::Sprite>& getGraphicsSprite() { return graphicsSprite; }
     
     // Set callback for when script completes
     void setOnScriptComplete(std::function<void()> callback) { onScriptComplete = callback; }
 
 private:
+    // Background decode queued on the thread pool
+    struct PendingBackground {
+        std::future<std::optional<sf::Image>> image;
+        std::shared_ptr<std::atomic<bool>> cancelled;  // Checked before the decode starts
+    };
+    
+    // Queue a decode unless the texture is loaded or already pending
+    void requestBackground(Symbol background);
+    
+    // Flag a decode as cancelled and keep its future until the job has finished
+    void cancelBackground(PendingBackground& pending);
+    
+    // Manifest entry of background <name> (asset id images/<name>), nullptr if unknown
+    static const AssetInfo* backgroundAsset(const ResourceManager& resources, std::string_view name);
+    
+    // Decode the background's file as listed in the asset manifest, downscaled to fit (0x0 = full size)
+    static std::optional<sf::Image> decodeBackground(const ResourceManager& resources, const std::string& name,
+                                                     sf::Vector2u fit);
+    
+    // Size the background should have for the current display size (0x0 if unknown)
+    sf::Vector2u backgroundTargetSize(Symbol background) const;
+    
+    // Whether a texture of textureSize is close enough to the target size to keep
+    bool fitsDisplay(Symbol background, sf::Vector2u textureSize) const;
+    bool hasFittingTexture(Symbol background) const;
+    
+    // Upload (or reuse) the background texture and point the sprite at it
+    void showBackground(Symbol background);
+    
     ResourceManager& resources;
-    GameScript script;
+    std::shared_ptr<const GameScript> script;
     const Scene* currentScene;
+    std::uint32_t currentSceneIndex = SCENE_NONE;
     std::unique_ptr<sf::Sprite> graphicsSprite;
+    TextureHandle backgroundTexture;  // Keeps graphicsSprite's texture pinned
     std::function<void()> onScriptComplete;
+    std::unordered_map<Symbol, PendingBackground> pendingBackgrounds;
+    std::vector<std::future<std::optional<sf::Image>>> cancelledBackgrounds;  // Jobs possibly still running
+    std::function<bool(const Condition&)> choiceFilter;
+    sf::Vector2u displaySize;  // Quantized graphics box size; 0x0 until known (full-size decodes)
+    int prefetchDepth = 2;
+    std::size_t prefetchLimit = 6;
 };
\ No newline at end of file
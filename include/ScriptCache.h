@@ -0,0 +1,61 @@
+#pragma once
+#include "ScriptParser.h"
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Process-wide LRU of parsed scripts keyed by path. An entry is only reused while the
+// file's modification time is unchanged, so edited scripts are picked up on the next load.
+class ScriptCache {
+public:
+    explicit ScriptCache(std::size_t capacity = DEFAULT_CAPACITY);
+
+    static ScriptCache& global();
+
+    // Waits for prefetches still running on the pool
+    ~ScriptCache();
+
+    // Cached script, or parse it now (waiting for an in-flight prefetch of the same path).
+    // nullptr if the script could not be loaded.
+    std::shared_ptr<const GameScript> load(const std::string& path);
+
+    // Start parsing path on the shared thread pool unless it is cached or already in flight
+    void prefetch(const std::string& path);
+
+    // Maximum number of scripts kept; extra least-recently-used entries are dropped
+    void setCapacity(std::size_t capacity);
+
+    void clear();
+
+    static constexpr std::size_t DEFAULT_CAPACITY = 8;
+
+private:
+    using FileTime = std::filesystem::file_time_type;
+    using ScriptPtr = std::shared_ptr<const GameScript>;
+
+    struct Entry {
+        std::string path;
+        FileTime modified;
+        ScriptPtr script;
+    };
+
+    static FileTime modifiedTime(const std::string& path);
+    static ScriptPtr parse(const std::string& path);
+
+    // Fresh cached entry moved to the front, or nullptr. Caller holds the mutex.
+    ScriptPtr findFresh(const std::string& path, FileTime modified);
+
+    // Insert as most recently used and trim to capacity. Caller holds the mutex.
+    void insert(const std::string& path, FileTime modified, ScriptPtr script);
+
+    std::mutex mutex;
+    std::size_t capacity;
+    std::list<Entry> entries;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+    std::unordered_map<std::string, std::shared_future<ScriptPtr>> inFlight;
+};
@@ -0,0 +1,10 @@
+#pragma once
+#include "ScriptParser.h"
+#include <string>
+
+// Writes GameScripts in the compiled (.uasc) format described in ScriptFormat.h
+class ScriptCompiler {
+public:
+    // Serialize script to path, returns false on I/O failure
+    static bool compile(const GameScript& script, const std::string& path);
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+// On-disk layout of compiled scripts (.uasc), produced by scriptc and mmapped by ScriptParser.
+// Every field is a 32-bit little-endian value and every offset is relative to the start of the file.
+//
+//   ScriptHeader
+//   SceneRecord[sceneCount]      scene table, in authoring order
+//   ChoiceRecord[choiceCount]    choices of all scenes, grouped per scene
+//   EffectRecord[effectCount]    effect ops of all scenes, grouped per scene
+//   StrRef[unlockCount]          metadata.unlocks
+//   string pool                  deduplicated UTF-8 bytes, not null-terminated
+namespace ScriptFormat {
+
+constexpr char kMagic[4] = {'U', 'A', 'S', 'C'};
+constexpr std::uint32_t kVersion = 2;  // 2: condition expressions
+constexpr const char* kExtension = ".uasc";
+
+// Slice of the string pool
+struct StrRef {
+    std::uint32_t offset = 0;
+    std::uint32_t length = 0;
+};
+
+struct ScriptHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t sceneCount;
+    std::uint32_t choiceCount;
+    std::uint32_t effectCount;
+    std::uint32_t unlockCount;
+    std::uint32_t sceneTableOffset;
+    std::uint32_t choiceTableOffset;
+    std::uint32_t effectTableOffset;
+    std::uint32_t unlockTableOffset;
+    std::uint32_t stringPoolOffset;
+    std::uint32_t stringPoolSize;
+    StrRef scriptId;
+    StrRef title;
+    StrRef estimatedTime;
+    std::int32_t chapter;
+};
+
+enum SceneFlags : std::uint32_t {
+    SceneHasEffects = 1u << 0
+};
+
+struct SceneRecord {
+    StrRef id;
+    StrRef background;
+    StrRef text;
+    StrRef speaker;
+    StrRef speakerColor;
+    std::uint32_t firstChoice;
+    std::uint32_t choiceCount;
+    std::uint32_t firstEffect;
+    std::uint32_t effectCount;
+    std::uint32_t flags;
+};
+
+enum ChoiceFlags : std::uint32_t {
+    ChoiceHasCondition = 1u << 0
+};
+
+struct ChoiceRecord {
+    StrRef text;
+    StrRef nextScene;
+    StrRef nextScript;
+    StrRef conditionFlag;
+    StrRef conditionFlagsNot;
+    StrRef conditionExpr;    // Source text; recompiled when the script is loaded
+    std::uint32_t flags;
+};
+
+enum class EffectOp : std::uint32_t {
+    AddFlag,
+    RemoveFlag,
+    ModifyStat,
+    AddItem,
+    RemoveItem
+};
+
+struct EffectRecord {
+    EffectOp op;
+    StrRef name;
+    std::int32_t amount;
+};
+
+static_assert(std::is_trivially_copyable_v<ScriptHeader>, "records are read straight from the mapping");
+static_assert(std::is_trivially_copyable_v<SceneRecord>, "records are read straight from the mapping");
+static_assert(std::is_trivially_copyable_v<ChoiceRecord>, "records are read straight from the mapping");
+static_assert(std::is_trivially_copyable_v<EffectRecord>, "records are read straight from the mapping");
+static_assert(sizeof(ScriptHeader) % 4 == 0 && sizeof(SceneRecord) % 4 == 0 &&
+              sizeof(ChoiceRecord) % 4 == 0 && sizeof(EffectRecord) % 4 == 0,
+              "tables must stay 4-byte aligned");
+
+} // namespace ScriptFormat
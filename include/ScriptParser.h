@@ -1,47 +1,141 @@
 // SFML 3.x
 
 #pragma once
+#include "ConditionExpr.h"
+#include "FlagSet.h"
+#include "SymbolTable.h"
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <optional>
 #include <unordered_map>
 
+// Scene and Choice text holds views into the owning GameScript's storage (a StringPool
+// for JSON scripts, the file mapping for compiled ones). Flag, stat, item, scene and
+// background ids are interned into the global SymbolTable at load time.
+//
+// Lazily opened scripts (ScriptParser::loadLazyScript) only record where each scene
+// lives in the file and parse a scene the first time GameScript::scene asks for it.
+
 // Condition for showing/hiding choices
 struct Condition {
-    std::string flag;  // Flag name to check (must be true)
-    std::string flagsNot;  // Flag name to check (must be false/absent)
+    Symbol flag = NO_SYMBOL;  // Flag to check (must be true)
+    Symbol flagsNot = NO_SYMBOL;  // Flag to check (must be false/absent)
     bool requiredValue = true;  // For 'flag' field only
+    std::string_view expression;  // Optional "expr" (see ConditionExpr.h); must hold as well
+    CompiledCondition compiled;   // What FlagSet::matches tests; see compile()
+    ConditionProgram program;     // expression, compiled
+    
+    // Rebuild compiled and program from the fields above; the parser does this for every
+    // condition it loads. False with a message in error if the expression is malformed.
+    bool compile(std::string& error) {
+        compiled = CompiledCondition{};
+        if (flag != NO_SYMBOL) compiled.require(flag, requiredValue);
+        if (flagsNot != NO_SYMBOL) compiled.require(flagsNot, false);
+        program = ConditionProgram{};
+        return expression.empty() || ConditionProgram::compile(expression, program, error);
+    }
 };
 
-// Effects applied when a scene is displayed
+// One step of a scene's effects
+struct EffectStep {
+    enum class Op : std::uint8_t { SetFlag, ClearFlag, AddStat, AddItem, RemoveItem };
+    
+    Op op;
+    Symbol target;            // Flag, stat or item
+    std::int32_t amount = 0;  // AddStat delta or item quantity
+    
+    bool operator==(const EffectStep& other) const {
+        return op == other.op && target == other.target && amount == other.amount;
+    }
+};
+
+// Effects applied when a scene is displayed, as one flat list of steps that
+// GameStateManager::applyEffects runs as a single transaction. In the script, addFlag and
+// removeFlag take a name or an array of names.
 struct Effects {
-    std::string addFlag;
-    std::string removeFlag;
-    std::unordered_map<std::string, int> modifyStats;
-    std::vector<std::pair<std::string, int>> addItems;
-    std::vector<std::pair<std::string, int>> removeItems;
+    std::vector<EffectStep> steps;
+    
+    void add(EffectStep::Op op, Symbol target, std::int32_t amount = 0) {
+        if (target != NO_SYMBOL) steps.push_back({op, target, amount});
+    }
+    
+    // Put steps in apply order: flags set, flags cleared, stats, items added, items removed,
+    // keeping script order within each. The parser does this for every Effects it loads, so
+    // the JSON and compiled paths agree however the keys were ordered.
+    void sort() {
+        std::stable_sort(steps.begin(), steps.end(),
+                         [](const EffectStep& a, const EffectStep& b) { return a.op < b.op; });
+    }
 };
 
+// Sentinel values for resolved scene indices
+constexpr std::uint32_t SCENE_NONE = 0xFFFFFFFFu;  // Unresolved or not applicable
+constexpr std::uint32_t SCENE_END = 0xFFFFFFFEu;   // "END" - finishes the script
+
 // Player choice in a scene
 struct Choice {
-    std::string text;
-    std::string nextScene;
-    std::string nextScript;
+    std::string_view text;
+    std::string_view nextScene;
+    std::string_view nextScript;
     std::optional<Condition> condition;
+    // Index of nextScene in GameScript::scenes, resolved at load
+    std::uint32_t target = SCENE_NONE;
 };
 
 // Individual scene with text, choices, and effects
 struct Scene {
-    std::string id;
-    std::string background;
-    std::string text;
-    std::string speaker;
-    std::string speakerColor;
+    std::string_view id;
+    Symbol symbol = NO_SYMBOL;  // Interned id
+    Symbol background = NO_SYMBOL;  // Resource id of the background image
+    std::string_view text;
+    std::string_view speaker;
+    std::string_view speakerColor;
     std::vector<Choice> choices;
     std::optional<Effects> effects;
 };
 
+// Append-only character storage backing the views of a JSON-parsed script
+class StringPool {
+public:
+    // Copy s into the pool and return a view that stays valid for the pool's lifetime
+    std::string_view add(std::string_view s);
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t blockUsed = BLOCK_SIZE;
+    size_t blockCapacity = BLOCK_SIZE;
+};
+
+// Open-addressing hash table from interned scene id to index in GameScript::scenes
+class SceneIndex {
+public:
+    // Rebuild the table for scenes; duplicate ids keep their first occurrence
+    void build(const std::vector<Scene>& scenes);
+    
+    // Rebuild the table from scene ids in scene order
+    void build(const std::vector<Symbol>& sceneIds);
+    
+    // Index of the scene with this id, or SCENE_NONE
+    std::uint32_t find(Symbol sceneId) const;
+
+private:
+    struct Slot {
+        Symbol key = NO_SYMBOL;
+        std::uint32_t scene = SCENE_NONE;
+    };
+    
+    static size_t slotFor(Symbol key, unsigned shift);
+    
+    std::vector<Slot> slots;  // Power-of-two size, at most half full
+    unsigned shift = 32;      // 32 - log2(slots.size())
+};
+
 // Script metadata (chapter info, unlocks, etc.)
 struct ScriptMetadata {
     int chapter = 1;
@@ -49,20 +143,66 @@ struct ScriptMetadata {
     std::string estimatedTime;
 };
 
+// Scene byte ranges and already parsed scenes of a lazily opened script (ScriptParser.cpp)
+class LazySceneTable;
+
 // Complete game script with metadata and scenes
 struct GameScript {
     std::string scriptId;
     std::string title;
     ScriptMetadata metadata;
-    std::vector<Scene> scenes;
+    std::vector<Scene> scenes;             // Every scene, empty for lazily opened scripts
+    SceneIndex index;                      // Built once per load, see ScriptParser::link
+    std::shared_ptr<const void> storage;   // Keeps the memory behind the scene views alive
+    std::shared_ptr<LazySceneTable> lazy;  // Set by ScriptParser::loadLazyScript
+    
+    // Number of scenes, including lazy ones that have not been parsed yet
+    std::uint32_t sceneCount() const;
+    
+    // Scene at index, parsed on first access for lazy scripts. nullptr if out of range or malformed.
+    const Scene* scene(std::uint32_t index) const;
+};
+
+// How JSON files are parsed
+enum class JsonParseMode {
+    Streaming,  // SAX events fill the result directly, no intermediate document
+    Dom         // Parse into a full nlohmann::json document first, then walk it
 };
 
 // Parses JSON script files
 class ScriptParser {
 public:
-    // Load script from JSON file
+    // Load script from JSON file, preferring an up-to-date compiled (.uasc) sibling.
+    // JSON files of LAZY_LOAD_THRESHOLD bytes or more are opened lazily.
     static std::optional<GameScript> loadScript(const std::string& path);
     
+    static constexpr std::uintmax_t LAZY_LOAD_THRESHOLD = 4 * 1024 * 1024;
+    
+    // Load script from JSON file, ignoring any compiled version. Both modes produce identical scripts.
+    static std::optional<GameScript> loadJsonScript(const std::string& path,
+                                                    JsonParseMode mode = JsonParseMode::Streaming);
+    
+    // Map a compiled script produced by scriptc
+    static std::optional<GameScript> loadCompiledScript(const std::string& path);
+    
+    // Scan a JSON script for scene boundaries only; scenes are parsed when first accessed
+    static std::optional<GameScript> loadLazyScript(const std::string& path);
+    
+    // Path of the compiled script that corresponds to a JSON script path
+    static std::string compiledPathFor(const std::string& path);
+    
+    // Build the scene index and resolve every Choice::target, reporting unknown scene ids.
+    // Returns false if any target could not be resolved (the script is still usable).
+    // Lazy scripts resolve targets as each scene is parsed instead.
+    static bool link(GameScript& script);
+    
     // Find a scene by ID in the script
-    static const Scene* findScene(const GameScript& script, const std::string& sceneId);
+    static const Scene* findScene(const GameScript& script, std::string_view sceneId);
+    
+    // Index of a scene by ID, or SCENE_NONE
+    static std::uint32_t findSceneIndex(const GameScript& script, std::string_view sceneId);
+
+private:
+    static std::optional<GameScript> loadJsonScriptDom(const std::string& path);
+    static std::optional<GameScript> loadJsonScriptStreaming(const std::string& path);
 };
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Compact id for an interned string (flag, stat, scene, item or resource id)
+using Symbol = std::uint32_t;
+constexpr Symbol NO_SYMBOL = 0xFFFFFFFFu;
+
+// Process-wide string interner. Strings are hashed once when scripts, items and
+// resources are loaded; runtime code then compares and hashes plain integers.
+// Ids are dense (0, 1, 2, ...) and never reused, so they can index arrays.
+class SymbolTable {
+public:
+    static SymbolTable& global();
+    
+    // Id for name, adding it on first use
+    Symbol intern(std::string_view name);
+    
+    // Id for name, or NO_SYMBOL if it was never interned
+    Symbol find(std::string_view name) const;
+    
+    // String for an id (empty for NO_SYMBOL); stays valid for the process lifetime
+    std::string_view name(Symbol id) const;
+    
+    size_t size() const;
+
+private:
+    mutable std::shared_mutex mutex;
+    std::deque<std::string> names;                    // Stable storage, indexed by Symbol
+    std::unordered_map<std::string_view, Symbol> ids; // Views into names
+};
+
+// Shorthands for the global table
+inline Symbol intern(std::string_view name) { return SymbolTable::global().intern(name); }
+inline std::string_view symbolName(Symbol id) { return SymbolTable::global().name(id); }
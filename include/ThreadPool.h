@@ -0,0 +1,54 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed set of worker threads running queued jobs in FIFO order
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threadCount = defaultThreadCount());
+
+    // Runs every job still queued, then joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a job; the future carries its result or exception
+    template <typename F>
+    auto submit(F&& job) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+        std::future<Result> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.emplace_back([task]() { (*task)(); });
+        }
+        wake.notify_one();
+        return result;
+    }
+
+    std::size_t size() const { return workers.size(); }
+
+    // One thread per core, leaving one for the main thread
+    static std::size_t defaultThreadCount();
+
+    // Process-wide pool for background loading work
+    static ThreadPool& shared();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
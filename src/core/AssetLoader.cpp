@@ -0,0 +1,188 @@
+// SFML 3.x
+
+#include "AssetLoader.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <variant>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// What a pool thread hands back to the main thread
+struct Decoded {
+    std::variant<std::monostate, sf::Image, sf::Font, sf::SoundBuffer> asset;
+    double workerMs = 0.0;
+};
+
+} // namespace
+
+void AssetLoader::addTexture(Symbol id, const std::string& path) {
+    requests.push_back({Kind::Texture, id, path, {}});
+}
+
+void AssetLoader::addFont(const std::string& id, const std::string& path) {
+    requests.push_back({Kind::Font, intern(id), path, {}});
+}
+
+void AssetLoader::addSoundBuffer(const std::string& id, const std::string& path) {
+    requests.push_back({Kind::SoundBuffer, intern(id), path, {}});
+}
+
+void AssetLoader::addMusic(const std::string& id, const std::string& path) {
+    requests.push_back({Kind::Music, intern(id), path, {}});
+}
+
+void AssetLoader::addImage(Symbol id, const std::string& path, sf::Vector2u maxSize) {
+    requests.push_back({Kind::Image, id, path, maxSize});
+}
+
+bool AssetLoader::load(ResourceManager& resources) {
+    auto start = Clock::now();
+
+    // Queue every decode before doing any main-thread work so the pool starts immediately
+    std::vector<std::future<Decoded>> pending(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const Request& request = requests[i];
+        if (request.kind == Kind::Music) {
+            continue;
+        }
+
+        pending[i] = ThreadPool::shared().submit([&resources, kind = request.kind, path = request.path, maxSize = request.maxSize]() {
+            auto decodeStart = Clock::now();
+            Decoded decoded;
+            switch (kind) {
+                case Kind::Texture:
+                case Kind::Image: {
+                    sf::Image image;
+                    if (resources.decodeImage(image, path, maxSize)) decoded.asset = std::move(image);
+                    break;
+                }
+                case Kind::Font: {
+                    sf::Font font;
+                    if (resources.decodeFont(font, path)) decoded.asset = std::move(font);
+                    break;
+                }
+                case Kind::SoundBuffer: {
+                    sf::SoundBuffer buffer;
+                    if (resources.decodeSoundBuffer(buffer, path)) decoded.asset = std::move(buffer);
+                    break;
+                }
+                default:
+                    break;
+            }
+            decoded.workerMs = millisecondsSince(decodeStart);
+            return decoded;
+        });
+    }
+
+    timings.clear();
+    timings.resize(requests.size());
+
+    // Music only opens a stream, so it runs here while the pool decodes
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const Request& request = requests[i];
+        Timing& timing = timings[i];
+        timing.id = std::string(symbolName(request.id));
+        timing.path = request.path;
+        if (request.kind == Kind::Music) {
+            auto openStart = Clock::now();
+            timing.loaded = resources.loadMusic(timing.id, request.path);
+            timing.mainMs = millisecondsSince(openStart);
+        }
+    }
+
+    // Hand decoded assets over in declaration order; textures are uploaded here
+    bool allLoaded = true;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const Request& request = requests[i];
+        Timing& timing = timings[i];
+        if (request.kind == Kind::Music) {
+            allLoaded = allLoaded && timing.loaded;
+            continue;
+        }
+
+        Decoded decoded = pending[i].get();
+        timing.workerMs = decoded.workerMs;
+
+        auto mainStart = Clock::now();
+        switch (request.kind) {
+            case Kind::Texture:
+                if (auto* image = std::get_if<sf::Image>(&decoded.asset)) {
+                    timing.loaded = resources.addTexture(request.id, *image);
+                } else {
+                    std::cerr << "Failed to load texture: " << request.path << std::endl;
+                }
+                break;
+            case Kind::Image:
+                if (auto* image = std::get_if<sf::Image>(&decoded.asset)) {
+                    images.emplace_back(request.id, std::move(*image));
+                    timing.loaded = true;
+                } else {
+                    std::cerr << "Failed to load image: " << request.path << std::endl;
+                }
+                break;
+            case Kind::Font:
+                if (auto* font = std::get_if<sf::Font>(&decoded.asset)) {
+                    resources.addFont(request.id, std::move(*font));
+                    timing.loaded = true;
+                } else {
+                    std::cerr << "Failed to load font: " << request.path << std::endl;
+                }
+                break;
+            case Kind::SoundBuffer:
+                if (auto* buffer = std::get_if<sf::SoundBuffer>(&decoded.asset)) {
+                    resources.addSoundBuffer(request.id, std::move(*buffer));
+                    timing.loaded = true;
+                } else {
+                    std::cerr << "Failed to load sound buffer: " << request.path << std::endl;
+                }
+                break;
+            default:
+                break;
+        }
+        timing.mainMs = millisecondsSince(mainStart);
+        allLoaded = allLoaded && timing.loaded;
+    }
+
+    requests.clear();
+    totalMs = millisecondsSince(start);
+    return allLoaded;
+}
+
+std::optional<sf::Image> AssetLoader::takeImage(Symbol id) {
+    for (auto it = images.begin(); it != images.end(); ++it) {
+        if (it->first == id) {
+            sf::Image image = std::move(it->second);
+            images.erase(it);
+            return image;
+        }
+    }
+    return std::nullopt;
+}
+
+void AssetLoader::printReport(std::ostream& out) const {
+    double workerSum = 0.0;
+    double mainSum = 0.0;
+
+    out << std::left << std::setw(14) << "asset" << std::setw(42) << "path"
+        << std::right << std::setw(11) << "worker ms" << std::setw(10) << "main ms" << std::endl;
+    for (const auto& timing : timings) {
+        out << std::left << std::setw(14) << timing.id << std::setw(42) << timing.path
+            << std::right << std::fixed << std::setprecision(2)
+            << std::setw(11) << timing.workerMs << std::setw(10) << timing.mainMs
+            << (timing.loaded ? "" : "  FAILED") << std::endl;
+        workerSum += timing.workerMs;
+        mainSum += timing.mainMs;
+    }
+    out << "Loaded " << timings.size() << " assets in " << std::fixed << std::setprecision(2) << totalMs
+        << " ms (" << workerSum << " ms decode on " << ThreadPool::shared().size()
+        << " threads, " << mainSum << " ms on main thread)" << std::endl;
+}
@@ -0,0 +1,282 @@
+#include "AssetManifest.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::uint32_t readBigEndian(const unsigned char* bytes, int count) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < count; ++i) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+// IHDR is always the first chunk, so the size sits at a fixed offset
+bool readPngSize(std::istream& in, std::uint32_t& width, std::uint32_t& height) {
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    unsigned char header[24];
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        !std::equal(signature, signature + 8, header) || std::string(header + 12, header + 16) != "IHDR") {
+        return false;
+    }
+    width = readBigEndian(header + 16, 4);
+    height = readBigEndian(header + 20, 4);
+    return true;
+}
+
+// Walk the marker segments (seeking over their payloads) until the first start-of-frame
+bool readJpegSize(std::istream& in, std::uint32_t& width, std::uint32_t& height) {
+    unsigned char soi[2];
+    if (!in.read(reinterpret_cast<char*>(soi), 2) || soi[0] != 0xFF || soi[1] != 0xD8) {
+        return false;
+    }
+
+    while (in) {
+        int byte = in.get();
+        if (byte != 0xFF) {
+            return false;
+        }
+        int marker = in.get();
+        while (marker == 0xFF) {
+            marker = in.get();  // Fill bytes
+        }
+        if (marker == EOF || marker == 0xD9 || marker == 0xDA) {
+            return false;  // End of image or scan data before any frame header
+        }
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+            continue;  // Markers without a length
+        }
+
+        unsigned char length[2];
+        if (!in.read(reinterpret_cast<char*>(length), 2)) {
+            return false;
+        }
+        std::uint32_t segmentLength = readBigEndian(length, 2);
+        if (segmentLength < 2) {
+            return false;
+        }
+
+        bool startOfFrame = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+        if (startOfFrame) {
+            unsigned char frame[5];
+            if (!in.read(reinterpret_cast<char*>(frame), sizeof(frame))) {
+                return false;
+            }
+            height = readBigEndian(frame + 1, 2);
+            width = readBigEndian(frame + 3, 2);
+            return true;
+        }
+        in.seekg(segmentLength - 2, std::ios::cur);
+    }
+    return false;
+}
+
+// Which file wins when two share an id (lower is preferred)
+int formatPriority(AssetFormat format) {
+    switch (format) {
+        case AssetFormat::Jpeg: return 0;
+        case AssetFormat::Png: return 1;
+        default: return 2;
+    }
+}
+
+bool isSkipped(const std::string& relative, const std::vector<std::string>& skip) {
+    for (const auto& entry : skip) {
+        if (relative == entry || relative.compare(0, entry.size() + 1, entry + "/") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool AssetManifest::scan(const std::string& root, const std::string& pathPrefix, const std::vector<std::string>& skip) {
+    clear();
+
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file()) {
+            continue;
+        }
+        fs::path relative = fs::relative(it->path(), root);
+        std::string relativeName = relative.generic_string();
+        if (isSkipped(relativeName, skip)) {
+            continue;
+        }
+
+        AssetInfo info;
+        info.format = formatForExtension(relative.extension().string());
+        if (info.format == AssetFormat::Unknown) {
+            continue;
+        }
+        info.id = relative.parent_path().empty() ? relative.stem().string()
+                                                 : (relative.parent_path() / relative.stem()).generic_string();
+        info.path = pathPrefix + relativeName;
+        info.bytes = it->file_size();
+
+        if (info.format == AssetFormat::Jpeg || info.format == AssetFormat::Png) {
+            // Trust the file's signature over its extension
+            std::ifstream file(it->path(), std::ios::binary);
+            if (readJpegSize(file, info.width, info.height)) {
+                info.format = AssetFormat::Jpeg;
+            } else if (file.clear(), file.seekg(0), readPngSize(file, info.width, info.height)) {
+                info.format = AssetFormat::Png;
+            } else {
+                std::cerr << "Unreadable image header, skipping: " << info.path << std::endl;
+                continue;
+            }
+        }
+        add(std::move(info));
+    }
+    if (ec) {
+        std::cerr << "Failed to scan assets in " << root << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    std::sort(assets.begin(), assets.end(), [](const AssetInfo& a, const AssetInfo& b) { return a.id < b.id; });
+    byId.clear();
+    byPath.clear();
+    for (std::size_t i = 0; i < assets.size(); ++i) {
+        byId[assets[i].id] = i;
+        byPath[assets[i].path] = i;
+    }
+    return true;
+}
+
+void AssetManifest::add(AssetInfo info) {
+    auto it = byId.find(info.id);
+    if (it == byId.end()) {
+        byId[info.id] = assets.size();
+        byPath[info.path] = assets.size();
+        assets.push_back(std::move(info));
+        return;
+    }
+
+    AssetInfo& existing = assets[it->second];
+    if (formatPriority(info.format) < formatPriority(existing.format)) {
+        byPath.erase(existing.path);
+        byPath[info.path] = it->second;
+        existing = std::move(info);
+    }
+}
+
+bool AssetManifest::loadFromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return loadFromMemory(text.data(), text.size());
+}
+
+bool AssetManifest::loadFromMemory(const void* data, std::size_t size) {
+    using json = nlohmann::json;
+    clear();
+
+    const char* begin = static_cast<const char*>(data);
+    json manifest = json::parse(begin, begin + size, nullptr, false);
+    if (manifest.is_discarded() || manifest.value("version", 0u) != VERSION || !manifest.contains("assets")) {
+        std::cerr << "Invalid asset manifest" << std::endl;
+        return false;
+    }
+
+    for (const auto& entry : manifest["assets"]) {
+        AssetInfo info;
+        info.id = entry.value("id", "");
+        info.path = entry.value("path", "");
+        info.format = formatFromName(entry.value("format", ""));
+        info.width = entry.value("width", 0u);
+        info.height = entry.value("height", 0u);
+        info.bytes = entry.value("bytes", std::uint64_t{0});
+        if (!info.id.empty() && !info.path.empty()) {
+            add(std::move(info));
+        }
+    }
+    return true;
+}
+
+std::string AssetManifest::toJsonString() const {
+    using json = nlohmann::json;
+    json entries = json::array();
+    for (const auto& info : assets) {
+        json entry = {{"id", info.id}, {"path", info.path}, {"format", formatName(info.format)}, {"bytes", info.bytes}};
+        if (info.width > 0) {
+            entry["width"] = info.width;
+            entry["height"] = info.height;
+        }
+        entries.push_back(std::move(entry));
+    }
+    return json{{"version", VERSION}, {"assets", std::move(entries)}}.dump(2);
+}
+
+bool AssetManifest::saveToFile(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write asset manifest: " << path << std::endl;
+        return false;
+    }
+    file << toJsonString() << '\n';
+    return static_cast<bool>(file);
+}
+
+const AssetInfo* AssetManifest::find(const std::string& id) const {
+    auto it = byId.find(id);
+    return it != byId.end() ? &assets[it->second] : nullptr;
+}
+
+const AssetInfo* AssetManifest::findByPath(const std::string& path) const {
+    auto it = byPath.find(path);
+    return it != byPath.end() ? &assets[it->second] : nullptr;
+}
+
+void AssetManifest::clear() {
+    assets.clear();
+    byId.clear();
+    byPath.clear();
+}
+
+AssetFormat AssetManifest::formatForExtension(const std::string& extension) {
+    std::string ext = extension;
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (ext == ".jpeg" || ext == ".jpg") return AssetFormat::Jpeg;
+    if (ext == ".png") return AssetFormat::Png;
+    if (ext == ".ttf" || ext == ".otf") return AssetFormat::Font;
+    if (ext == ".wav") return AssetFormat::Wav;
+    if (ext == ".ogg") return AssetFormat::Ogg;
+    if (ext == ".mp3") return AssetFormat::Mp3;
+    if (ext == ".flac") return AssetFormat::Flac;
+    if (ext == ".json") return AssetFormat::Json;
+    return AssetFormat::Unknown;
+}
+
+const char* AssetManifest::formatName(AssetFormat format) {
+    switch (format) {
+        case AssetFormat::Jpeg: return "jpeg";
+        case AssetFormat::Png: return "png";
+        case AssetFormat::Font: return "font";
+        case AssetFormat::Wav: return "wav";
+        case AssetFormat::Ogg: return "ogg";
+        case AssetFormat::Mp3: return "mp3";
+        case AssetFormat::Flac: return "flac";
+        case AssetFormat::Json: return "json";
+        default: return "unknown";
+    }
+}
+
+AssetFormat AssetManifest::formatFromName(const std::string& name) {
+    for (AssetFormat format : {AssetFormat::Jpeg, AssetFormat::Png, AssetFormat::Font, AssetFormat::Wav,
+                               AssetFormat::Ogg, AssetFormat::Mp3, AssetFormat::Flac, AssetFormat::Json}) {
+        if (name == formatName(format)) {
+            return format;
+        }
+    }
+    return AssetFormat::Unknown;
+}
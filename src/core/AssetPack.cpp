@@ -0,0 +1,117 @@
+#include "AssetPack.h"
+#include "AssetPackFormat.h"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+using namespace AssetPackFormat;
+
+namespace {
+
+// splitmix64 step, to spread the stamp inputs over all 64 bits
+std::uint64_t mix(std::uint64_t hash, std::uint64_t value) {
+    hash += value + 0x9E3779B97F4A7C15ull;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+    return hash ^ (hash >> 31);
+}
+
+} // namespace
+
+bool AssetPack::open(const std::string& path) {
+    close();
+    if (!file.open(path)) {
+        return false;
+    }
+
+    auto fail = [this, &path](const char* reason) {
+        std::cerr << "Invalid asset pack " << path << ": " << reason << std::endl;
+        close();
+        return false;
+    };
+
+    if (file.size() < sizeof(PackHeader)) {
+        return fail("truncated header");
+    }
+    PackHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        return fail("wrong format or version");
+    }
+    if (header.slotCount == 0 || (header.slotCount & (header.slotCount - 1)) != 0 ||
+        header.slotCount < header.entryCount) {
+        return fail("bad hash table size");
+    }
+
+    const std::uint64_t size = file.size();
+    if (header.entryTableOffset % 4 != 0 || header.slotTableOffset % 4 != 0 ||
+        header.entryTableOffset + static_cast<std::uint64_t>(header.entryCount) * sizeof(PackEntry) > size ||
+        header.slotTableOffset + static_cast<std::uint64_t>(header.slotCount) * sizeof(std::uint32_t) > size ||
+        static_cast<std::uint64_t>(header.nameTableOffset) + header.nameTableSize > size) {
+        return fail("truncated tables");
+    }
+
+    // Check every entry once so lookups can trust the tables
+    const auto* entries = reinterpret_cast<const PackEntry*>(file.data() + header.entryTableOffset);
+    for (std::uint32_t i = 0; i < header.entryCount; ++i) {
+        const PackEntry& entry = entries[i];
+        if (static_cast<std::uint64_t>(entry.nameOffset) + entry.nameLength > header.nameTableSize ||
+            static_cast<std::uint64_t>(entry.dataOffset) + entry.dataSize > size) {
+            return fail("entry out of range");
+        }
+    }
+    const auto* slots = reinterpret_cast<const std::uint32_t*>(file.data() + header.slotTableOffset);
+    for (std::uint32_t i = 0; i < header.slotCount; ++i) {
+        if (slots[i] != kEmptySlot && slots[i] >= header.entryCount) {
+            return fail("slot out of range");
+        }
+    }
+
+    entryCount = header.entryCount;
+    slotCount = header.slotCount;
+    entryTableOffset = header.entryTableOffset;
+    slotTableOffset = header.slotTableOffset;
+    nameTableOffset = header.nameTableOffset;
+
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    packStamp = mix(mix(0, ec ? 0 : static_cast<std::uint64_t>(mtime.time_since_epoch().count())), size);
+    return true;
+}
+
+void AssetPack::close() {
+    file.close();
+    entryCount = 0;
+    slotCount = 0;
+    packStamp = 0;
+}
+
+std::int64_t AssetPack::entryStamp(const Blob& blob) const {
+    std::uint64_t offset = static_cast<std::uint64_t>(blob.data - file.data());
+    std::uint64_t stamp = mix(mix(packStamp, offset), blob.size);
+    return stamp != 0 ? static_cast<std::int64_t>(stamp) : 1;
+}
+
+std::optional<AssetPack::Blob> AssetPack::find(std::string_view path) const {
+    if (!isOpen()) {
+        return std::nullopt;
+    }
+
+    const auto* entries = reinterpret_cast<const PackEntry*>(file.data() + entryTableOffset);
+    const auto* slots = reinterpret_cast<const std::uint32_t*>(file.data() + slotTableOffset);
+    const char* names = reinterpret_cast<const char*>(file.data()) + nameTableOffset;
+
+    const std::uint32_t hash = hashPath(path);
+    const std::uint32_t mask = slotCount - 1;
+    for (std::uint32_t probe = 0, pos = firstSlot(hash, slotCount); probe < slotCount; ++probe, pos = (pos + 1) & mask) {
+        std::uint32_t index = slots[pos];
+        if (index == kEmptySlot) {
+            break;
+        }
+        const PackEntry& entry = entries[index];
+        if (entry.hash == hash && std::string_view(names + entry.nameOffset, entry.nameLength) == path) {
+            return Blob{file.data() + entry.dataOffset, entry.dataSize};
+        }
+    }
+    return std::nullopt;
+}
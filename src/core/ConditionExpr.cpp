@@ -0,0 +1,304 @@
+#include "ConditionExpr.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+namespace {
+
+// Recursive descent over the grammar in ConditionExpr.h, reading straight from the source
+class ConditionParser {
+public:
+    explicit ConditionParser(std::string_view source) : source(source) {}
+
+    std::unique_ptr<ExprNode> parse(std::string& error) {
+        std::unique_ptr<ExprNode> root = parseOr();
+        skipSpace();
+        if (root && position < source.size()) {
+            fail("unexpected '" + std::string(1, source[position]) + "'");
+        }
+        if (!message.empty()) {
+            error = message + " at column " + std::to_string(errorColumn + 1) + " in \"" + std::string(source) + "\"";
+            return nullptr;
+        }
+        return root;
+    }
+
+private:
+    // Deep enough for any hand-written condition, shallow enough to keep recursion bounded
+    static constexpr int MAX_NESTING = 64;
+
+    std::unique_ptr<ExprNode> parseOr() {
+        std::unique_ptr<ExprNode> left = parseAnd();
+        while (left && (accept("||") || acceptWord("or"))) {
+            left = binary(ExprNode::Kind::Or, std::move(left), parseAnd());
+        }
+        return left;
+    }
+
+    std::unique_ptr<ExprNode> parseAnd() {
+        std::unique_ptr<ExprNode> left = parseUnary();
+        while (left && (accept("&&") || acceptWord("and"))) {
+            left = binary(ExprNode::Kind::And, std::move(left), parseUnary());
+        }
+        return left;
+    }
+
+    std::unique_ptr<ExprNode> parseUnary() {
+        if (accept("!") || acceptWord("not")) {
+            if (++nesting > MAX_NESTING) {
+                return fail("expression nested too deeply");
+            }
+            std::unique_ptr<ExprNode> operand = parseUnary();
+            --nesting;
+            if (!operand) {
+                return nullptr;
+            }
+            auto node = std::make_unique<ExprNode>();
+            node->kind = ExprNode::Kind::Not;
+            node->left = std::move(operand);
+            return node;
+        }
+        return parseCompare();
+    }
+
+    std::unique_ptr<ExprNode> parseCompare() {
+        std::unique_ptr<ExprNode> left = parseOperand();
+        if (!left) {
+            return nullptr;
+        }
+        static const std::pair<const char*, ExprNode::Compare> operators[] = {
+            {"==", ExprNode::Compare::Eq}, {"!=", ExprNode::Compare::Ne},
+            {"<=", ExprNode::Compare::Le}, {">=", ExprNode::Compare::Ge},
+            {"<", ExprNode::Compare::Lt}, {">", ExprNode::Compare::Gt}
+        };
+        for (const auto& [text, compare] : operators) {
+            if (accept(text)) {
+                std::unique_ptr<ExprNode> node = binary(ExprNode::Kind::Compare, std::move(left), parseOperand());
+                if (node) {
+                    node->compare = compare;
+                }
+                return node;
+            }
+        }
+        return left;
+    }
+
+    std::unique_ptr<ExprNode> parseOperand() {
+        skipSpace();
+        if (accept("(")) {
+            if (++nesting > MAX_NESTING) {
+                return fail("expression nested too deeply");
+            }
+            std::unique_ptr<ExprNode> inner = parseOr();
+            --nesting;
+            if (inner && !accept(")")) {
+                return fail("expected ')'");
+            }
+            return inner;
+        }
+
+        skipSpace();
+        const std::size_t start = position;
+        bool negative = accept("-");
+        skipSpace();
+        if (position < source.size() && std::isdigit(static_cast<unsigned char>(source[position]))) {
+            long long value = 0;
+            while (position < source.size() && std::isdigit(static_cast<unsigned char>(source[position]))) {
+                value = value * 10 + (source[position++] - '0');
+                if (value > std::numeric_limits<std::int32_t>::max()) {
+                    errorColumn = start;
+                    return fail("number out of range");
+                }
+            }
+            auto node = std::make_unique<ExprNode>();
+            node->value = static_cast<std::int32_t>(negative ? -value : value);
+            return node;
+        }
+        if (negative) {
+            return fail("expected a number after '-'");
+        }
+
+        std::string_view word = readName();
+        if (word.empty()) {
+            return fail(position < source.size() ? "expected a value" : "unexpected end of expression");
+        }
+        if (word == "true" || word == "false") {
+            auto node = std::make_unique<ExprNode>();
+            node->value = word == "true" ? 1 : 0;
+            return node;
+        }
+
+        auto node = std::make_unique<ExprNode>();
+        node->kind = ExprNode::Kind::Flag;
+        ExprNode::Kind call = ExprNode::Kind::Constant;
+        if (word == "flag") call = ExprNode::Kind::Flag;
+        else if (word == "stat") call = ExprNode::Kind::Stat;
+        else if (word == "items") call = ExprNode::Kind::Items;
+        if (call != ExprNode::Kind::Constant && accept("(")) {
+            skipSpace();
+            std::string_view argument = readName();
+            if (argument.empty()) {
+                return fail("expected a name in " + std::string(word) + "()");
+            }
+            if (!accept(")")) {
+                return fail("expected ')'");
+            }
+            node->kind = call;
+            word = argument;
+        }
+        node->symbol = intern(word);
+        return node;
+    }
+
+    std::unique_ptr<ExprNode> binary(ExprNode::Kind kind, std::unique_ptr<ExprNode> left, std::unique_ptr<ExprNode> right) {
+        if (!right) {
+            return nullptr;
+        }
+        auto node = std::make_unique<ExprNode>();
+        node->kind = kind;
+        node->left = std::move(left);
+        node->right = std::move(right);
+        return node;
+    }
+
+    // Names as used for flags, stats and items in scripts
+    std::string_view readName() {
+        std::size_t start = position;
+        while (position < source.size()) {
+            unsigned char c = static_cast<unsigned char>(source[position]);
+            if (!(std::isalnum(c) || c == '_' || c == '.')) {
+                break;
+            }
+            ++position;
+        }
+        return source.substr(start, position - start);
+    }
+
+    void skipSpace() {
+        while (position < source.size() && std::isspace(static_cast<unsigned char>(source[position]))) {
+            ++position;
+        }
+    }
+
+    bool accept(std::string_view token) {
+        skipSpace();
+        if (source.substr(position, token.size()) != token) {
+            return false;
+        }
+        // Keep "<" from eating the start of "<=" and "!" the start of "!="
+        if (token.size() == 1 && position + 1 < source.size() && source[position + 1] == '=' &&
+            (token == "<" || token == ">" || token == "!")) {
+            return false;
+        }
+        position += token.size();
+        return true;
+    }
+
+    bool acceptWord(std::string_view word) {
+        skipSpace();
+        std::size_t end = position + word.size();
+        if (source.substr(position, word.size()) != word ||
+            (end < source.size() && (std::isalnum(static_cast<unsigned char>(source[end])) || source[end] == '_'))) {
+            return false;
+        }
+        position = end;
+        return true;
+    }
+
+    std::unique_ptr<ExprNode> fail(std::string text) {
+        if (message.empty()) {
+            message = std::move(text);
+            errorColumn = std::min(errorColumn, position);
+        }
+        return nullptr;
+    }
+
+    std::string_view source;
+    std::size_t position = 0;
+    std::size_t errorColumn = std::numeric_limits<std::size_t>::max();
+    int nesting = 0;
+    std::string message;
+};
+
+// Emits bytecode for a tree; depth is the stack size before the node runs
+class ConditionEmitter {
+public:
+    using Op = ConditionProgram::Op;
+
+    explicit ConditionEmitter(std::vector<ConditionProgram::Instruction>& code) : code(code) {}
+
+    std::size_t maxDepth = 0;
+
+    void emit(const ExprNode& node, std::size_t depth) {
+        using Kind = ExprNode::Kind;
+        switch (node.kind) {
+            case Kind::Constant:
+                push(Op::Push, static_cast<std::uint32_t>(node.value), depth);
+                break;
+            case Kind::Flag:
+                push(Op::Flag, node.symbol, depth);
+                break;
+            case Kind::Stat:
+                push(Op::Stat, node.symbol, depth);
+                break;
+            case Kind::Items:
+                push(Op::Items, node.symbol, depth);
+                break;
+            case Kind::Not:
+                emit(*node.left, depth);
+                code.push_back({Op::Not, 0});
+                break;
+            case Kind::And:
+            case Kind::Or: {
+                // left, as 0/1; if it decides the result jump past right with it on the stack
+                emit(*node.left, depth);
+                code.push_back({Op::Bool, 0});
+                std::size_t jump = code.size();
+                code.push_back({node.kind == Kind::And ? Op::JumpIfFalse : Op::JumpIfTrue, 0});
+                emit(*node.right, depth);
+                code.push_back({Op::Bool, 0});
+                code[jump].arg = static_cast<std::uint32_t>(code.size());
+                break;
+            }
+            case Kind::Compare: {
+                emit(*node.left, depth);
+                emit(*node.right, depth + 1);
+                static const Op ops[] = {Op::Eq, Op::Ne, Op::Lt, Op::Le, Op::Gt, Op::Ge};
+                code.push_back({ops[static_cast<int>(node.compare)], 0});
+                break;
+            }
+        }
+    }
+
+private:
+    void push(Op op, std::uint32_t arg, std::size_t depth) {
+        code.push_back({op, arg});
+        maxDepth = std::max(maxDepth, depth + 1);
+    }
+
+    std::vector<ConditionProgram::Instruction>& code;
+};
+
+} // namespace
+
+std::unique_ptr<ExprNode> parseCondition(std::string_view source, std::string& error) {
+    return ConditionParser(source).parse(error);
+}
+
+bool ConditionProgram::compile(const ExprNode& root, ConditionProgram& program, std::string& error) {
+    std::vector<Instruction> code;
+    ConditionEmitter emitter(code);
+    emitter.emit(root, 0);
+    if (emitter.maxDepth > MAX_DEPTH) {
+        error = "expression needs " + std::to_string(emitter.maxDepth) + " stack slots, more than " +
+                std::to_string(MAX_DEPTH);
+        return false;
+    }
+    program.code = std::move(code);
+    return true;
+}
+
+bool ConditionProgram::compile(std::string_view source, ConditionProgram& program, std::string& error) {
+    std::unique_ptr<ExprNode> root = parseCondition(source, error);
+    return root && compile(*root, program, error);
+}
@@ -0,0 +1,175 @@
+#include "DecodedImageCache.h"
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char kMagic[4] = {'U', 'A', 'R', 'G'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kPixelAlignment = 64;
+
+struct CacheHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t maxWidth;
+    std::uint32_t maxHeight;
+    std::uint32_t pixelOffset;
+    std::uint32_t reserved;
+    std::uint64_t sourceSize;
+    std::int64_t sourceStamp;
+    std::uint64_t sourceHash;
+};
+
+// FNV-1a over the encoded bytes
+std::uint64_t hashBytes(const std::uint8_t* data, std::size_t size) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Hash the source, reading it from disk when it is not already in memory
+bool hashSource(const DecodedImageCache::Source& source, std::uint64_t& hash) {
+    if (source.data) {
+        hash = hashBytes(source.data, source.size);
+        return true;
+    }
+    std::ifstream file(source.path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    hash = hashBytes(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+    return bytes.size() == source.size;
+}
+
+} // namespace
+
+DecodedImageCache::DecodedImageCache(std::string directory) : directory(std::move(directory)) {}
+
+DecodedImageCache::Source DecodedImageCache::describeFile(const std::string& path) {
+    Source source;
+    source.path = path;
+    std::error_code ec;
+    source.size = static_cast<std::size_t>(fs::file_size(path, ec));
+    if (ec) {
+        source.size = 0;
+    }
+    auto mtime = fs::last_write_time(path, ec);
+    source.stamp = ec ? 0 : static_cast<std::int64_t>(mtime.time_since_epoch().count());
+    return source;
+}
+
+std::string DecodedImageCache::entryPath(const std::string& assetPath, ImageScaling::Size maxSize) const {
+    std::string name = assetPath;
+    for (char& c : name) {
+        if (c == '/' || c == '\\' || c == ':') {
+            c = '_';
+        }
+    }
+    if (maxSize.width > 0 && maxSize.height > 0) {
+        name += "@" + std::to_string(maxSize.width) + "x" + std::to_string(maxSize.height);
+    }
+    return directory + "/" + name + ".rgba";
+}
+
+std::unique_ptr<DecodedImageCache::Entry> DecodedImageCache::load(const Source& source, ImageScaling::Size maxSize) const {
+    auto entry = std::make_unique<Entry>();
+    if (source.size == 0 || !entry->file.open(entryPath(source.path, maxSize))) {
+        return nullptr;
+    }
+
+    const MappedFile& file = entry->file;
+    if (file.size() < sizeof(CacheHeader)) {
+        return nullptr;
+    }
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    std::uint64_t pixelBytes = static_cast<std::uint64_t>(header.width) * header.height * 4;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.maxWidth != maxSize.width || header.maxHeight != maxSize.height ||
+        header.sourceSize != source.size || header.pixelOffset < sizeof(CacheHeader) ||
+        header.pixelOffset + pixelBytes > file.size()) {
+        return nullptr;
+    }
+
+    // A matching stamp is enough. A different one (touched, copied or repacked) is a miss, so
+    // the caller re-stores the entry under the new stamp (temp + rename) and later loads skip
+    // the hash again. Only sources without a stamp are compared by content.
+    if (source.stamp != 0) {
+        if (header.sourceStamp != source.stamp) {
+            return nullptr;
+        }
+    } else {
+        std::uint64_t hash = 0;
+        if (!hashSource(source, hash) || hash != header.sourceHash) {
+            return nullptr;
+        }
+    }
+
+    entry->size = {header.width, header.height};
+    entry->pixelOffset = header.pixelOffset;
+    return entry;
+}
+
+bool DecodedImageCache::store(const Source& source, ImageScaling::Size maxSize, const std::uint8_t* rgba,
+                              ImageScaling::Size size) const {
+    CacheHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.width = size.width;
+    header.height = size.height;
+    header.maxWidth = maxSize.width;
+    header.maxHeight = maxSize.height;
+    header.pixelOffset = static_cast<std::uint32_t>((sizeof(CacheHeader) + kPixelAlignment - 1) / kPixelAlignment * kPixelAlignment);
+    header.sourceSize = source.size;
+    header.sourceStamp = source.stamp;
+    if (!hashSource(source, header.sourceHash)) {
+        return false;
+    }
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+
+    // Unique temp name so concurrent writers of the same entry do not interleave
+    static std::atomic<unsigned> counter{0};
+    std::string finalPath = entryPath(source.path, maxSize);
+    std::string tempPath = finalPath + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+                           "_" + std::to_string(counter++);
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Failed to write decoded image cache: " << tempPath << std::endl;
+            return false;
+        }
+        static const char zeros[kPixelAlignment] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(zeros, header.pixelOffset - sizeof(header));
+        out.write(reinterpret_cast<const char*>(rgba), static_cast<std::streamsize>(size.width) * size.height * 4);
+        if (!out) {
+            out.close();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    fs::rename(tempPath, finalPath, ec);
+    if (ec) {
+        // Another process may have the old entry mapped (Windows); it is simply refreshed next time
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
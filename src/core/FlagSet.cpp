@@ -0,0 +1,74 @@
+#include "FlagSet.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+int lowestBit(std::uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+} // namespace
+
+void CompiledCondition::require(Symbol flag, bool value) {
+    const std::uint32_t word = static_cast<std::uint32_t>(flag / FlagSet::WORD_BITS);
+    const std::uint64_t bit = std::uint64_t{1} << (flag % FlagSet::WORD_BITS);
+    const std::uint64_t expected = value ? bit : 0;
+
+    for (std::uint8_t i = 0; i < count; ++i) {
+        FlagTerm& term = terms[i];
+        if (term.word != word) {
+            continue;
+        }
+        if ((term.mask & bit) && (term.expected & bit) != expected) {
+            // Same flag required both ways: a term no word can match
+            term.mask = 0;
+            term.expected = 1;
+        } else {
+            term.mask |= bit;
+            term.expected |= expected;
+        }
+        return;
+    }
+    terms[count++] = {word, bit, expected};
+}
+
+void FlagSet::set(Symbol flag, bool value) {
+    if (flag == NO_SYMBOL) {
+        return;
+    }
+    const std::size_t word = flag / WORD_BITS;
+    const std::uint64_t bit = std::uint64_t{1} << (flag % WORD_BITS);
+    if (word >= values.size()) {
+        values.resize(word + 1, 0);
+        known.resize(word + 1, 0);
+    }
+    if (!(known[word] & bit)) {
+        known[word] |= bit;
+        ++count;
+    }
+    values[word] = value ? (values[word] | bit) : (values[word] & ~bit);
+}
+
+void FlagSet::clear() {
+    values.clear();
+    known.clear();
+    count = 0;
+}
+
+void FlagSet::forEach(const std::function<void(Symbol flag, bool value)>& visit) const {
+    for (std::size_t word = 0; word < known.size(); ++word) {
+        for (std::uint64_t bits = known[word]; bits != 0; bits &= bits - 1) {
+            int bit = lowestBit(bits);
+            visit(static_cast<Symbol>(word * WORD_BITS + bit), (values[word] >> bit) & 1);
+        }
+    }
+}
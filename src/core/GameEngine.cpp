@@ -6,27 +6,43 @@
 #include "SettingsState.h"
 #include "Button.h"
 #include "PlayingState.h"
+#include "AssetLoader.h"
+#include "AssetPackFormat.h"
+#include "SaveSlots.h"
 #include <iostream>
 
-GameEngine::GameEngine() {
-    resources.loadFont("main", "assets/fonts/MedievalSharp.ttf");
-    resources.loadTexture("cursor", "assets/images/cursor.png");  // Load cursor first
+GameEngine::GameEngine(bool reportStartup, bool decodedCache, bool journalSaves) : reportStartup(reportStartup) {
+    // Set before any state can save
+    SaveSlots::global().setJournaling(journalSaves);
     
-    resources.loadTexture("background", "assets/images/menuBackground.jpeg");
-    resources.loadTexture("logo", "assets/images/logo.png");
-    resources.loadTexture("title", "assets/images/title.png");
-    resources.loadTexture("start", "assets/images/start.png");
-    resources.loadTexture("settings", "assets/images/settings.png");
-    resources.loadSoundBuffer("click", "assets/sfx/click.wav");
-    resources.loadMusic("title", "assets/sfx/title.mp3");
+    // One mapping for every asset; anything missing from it is read from assets/
+    resources.mountPack(AssetPackFormat::kDefaultPackPath);
+    resources.loadManifest();
+    if (decodedCache) {
+        resources.enableDecodedCache();
+    }
+    
+    // Decode everything in parallel; textures are uploaded on this thread once decoded
+    AssetLoader loader;
+    loader.addFont("main", "assets/fonts/MedievalSharp.ttf");
+    loader.addTexture("cursor", "assets/images/cursor.png");
+    loader.addTexture("background", "assets/images/menuBackground.jpeg");
+    loader.addTexture("logo", "assets/images/logo.png");
+    loader.addTexture("title", "assets/images/title.png");
+    loader.addTexture("start", "assets/images/start.png");
+    loader.addTexture("settings", "assets/images/settings.png");
+    loader.addSoundBuffer("click", "assets/sfx/click.wav");
+    loader.addMusic("title", "assets/sfx/title.mp3");
+    loader.addImage("icon", "assets/images/logo.png");  // Needed BEFORE creating window
+    loader.load(resources);
     
-    // Load icon BEFORE creating window
-    sf::Image icon;
-    if (!icon.loadFromFile("assets/images/logo.png")) {
-        // Handle error - could log or use a default icon
-        // For now, just continue without icon
+    if (reportStartup) {
+        loader.printReport(std::cout);
     }
     
+    // Continue without an icon if it failed to load
+    sf::Image icon = loader.takeImage("icon").value_or(sf::Image());
+    
     // NOW construct the window (use 'window', not 'customWindow')
     window = std::make_unique<CustomWindow>(
         sf::Vector2u(1280u, 720u), 
@@ -57,6 +73,11 @@ void GameEngine::run() {
         float deltaTime = clock.restart().asSeconds();
         update(deltaTime);
         render();
+        
+        if (reportStartup && !firstFrameShown) {
+            firstFrameShown = true;
+            std::cout << "First frame after " << startupClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+        }
     }
 }
 
@@ -100,8 +121,8 @@ std::unique_ptr<GameState> GameEngine::createSettingsState() {
     return std::make_unique<SettingsState>(resources);
 }
 
-std::unique_ptr<GameState> GameEngine::createPlayingState(const std::string& scriptPath) {
-    return std::make_unique<PlayingState>(resources, scriptPath);
+std::unique_ptr<GameState> GameEngine::createPlayingState(const std::string& scriptPath, int saveSlot) {
+    return std::make_unique<PlayingState>(resources, itemRegistry, scriptPath, saveSlot);
 }
 
 void GameEngine::setupStateCallbacks(GameState* state) {
@@ -109,9 +130,9 @@ void GameEngine::setupStateCallbacks(GameState* state) {
         case GameStateType::MainMenu: {
             auto* mainMenu = static_cast<MainMenuState*>(state);
             
-            mainMenu->setOnStartClicked([this]() {
+            mainMenu->setOnStartClicked([this](int saveSlot) {
                 // Change this line to load your script instead of the placeholder StartState
-                pushState(createPlayingState("assets/scripts/intro.json"));
+                pushState(createPlayingState("assets/scripts/intro.json", saveSlot));
             });
             
             mainMenu->setOnSettingsClicked([this]() {
@@ -1,151 +1,533 @@
 #include "GameStateManager.h"
 #include "SceneManager.h"
 #include "InventorySystem.h"
-#include <fstream>
+#include "MappedFile.h"
+#include "SaveFormat.h"
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
 #include <iostream>
 
-GameStateManager::GameStateManager() {}
+namespace {
 
-// Check if condition is satisfied based on flags
-bool GameStateManager::checkCondition(const Condition& condition) const {
-    std::cout << "Checking condition - flag: '" << condition.flag 
-              << "', flagsNot: '" << condition.flagsNot << "'" << std::endl;
+using json = nlohmann::json;
+
+// Save contents collected from SAX events, committed only once the whole file parsed
+struct SaveSnapshot {
+    std::optional<std::string> currentScript;
+    std::optional<std::string> currentScene;
+    std::vector<std::pair<Symbol, bool>> flags;
+    std::vector<std::pair<Symbol, int>> stats;
+    std::optional<std::vector<std::pair<std::string, int>>> inventory;
+};
+
+// Streams a save (JSON text or CBOR) into a SaveSnapshot, mirroring the DOM walk in loadGameDom
+class SaveSaxHandler {
+public:
+    using string_t = json::string_t;
+    using number_integer_t = json::number_integer_t;
+    using number_unsigned_t = json::number_unsigned_t;
+    using number_float_t = json::number_float_t;
+    using binary_t = json::binary_t;
     
-    // Check 'flag' field (must match requiredValue)
-    if (!condition.flag.empty()) {
-        auto it = flags.find(condition.flag);
-        bool flagExists = (it != flags.end());
-        bool flagValue = flagExists ? it->second : false;
-        std::cout << "  Flag '" << condition.flag << "' exists: " << flagExists 
-                  << ", value: " << flagValue << ", required: " << condition.requiredValue << std::endl;
-        
-        // If flag doesn't exist, pass if requiredValue is false
-        if (it == flags.end()) {
-            return !condition.requiredValue;
+    explicit SaveSaxHandler(SaveSnapshot& save) : save(save) {}
+    
+    const std::string& error() const { return errorMessage; }
+    
+    bool null() { return scalar(); }
+    bool binary(binary_t&) { return scalar(); }
+    
+    bool boolean(bool value) {
+        if (top() == Ctx::Flags) {
+            save.flags.push_back({intern(currentKey), value});
+            return true;
         }
-        // If flag exists, must match required value
-        if (it->second != condition.requiredValue) {
-            return false;
+        return scalar();
+    }
+    
+    bool number_integer(number_integer_t value) { return number(static_cast<long long>(value)); }
+    bool number_unsigned(number_unsigned_t value) { return number(static_cast<long long>(value)); }
+    bool number_float(number_float_t value, const string_t&) { return number(static_cast<long long>(value)); }
+    
+    bool string(string_t& value) {
+        switch (top()) {
+            case Ctx::Root:
+                if (currentKey == "currentScript") save.currentScript = value;
+                else if (currentKey == "currentScene") save.currentScene = value;
+                return true;
+            case Ctx::InventoryEntry:
+                if (currentKey == "id") itemId = value;
+                else if (currentKey == "quantity") return fail("[json.exception.type_error.302] item quantity must be a number");
+                return true;
+            case Ctx::Flags:
+                return fail("[json.exception.type_error.302] flag '" + currentKey + "' must be a boolean");
+            case Ctx::Stats:
+                return fail("[json.exception.type_error.302] stat '" + currentKey + "' must be a number");
+            default:
+                return true;
         }
     }
     
-    // Check 'flagsNot' field (must be false or absent)
-    if (!condition.flagsNot.empty()) {
-        auto it = flags.find(condition.flagsNot);
-        bool flagExists = (it != flags.end());
-        bool flagValue = flagExists ? it->second : false;
-        std::cout << "  FlagsNot '" << condition.flagsNot << "' exists: " << flagExists 
-                  << ", value: " << flagValue << std::endl;
-        
-        // If flagsNot is true, condition fails
-        if (it != flags.end() && it->second == true) {
-            std::cout << "  -> Condition FAILED (flagsNot is true)" << std::endl;
-            return false;
+    bool start_object(std::size_t) {
+        Ctx next = Ctx::Skip;
+        if (stack.empty()) {
+            next = Ctx::Root;
+        } else if (top() == Ctx::Root && currentKey == "flags") {
+            next = Ctx::Flags;
+        } else if (top() == Ctx::Root && currentKey == "stats") {
+            next = Ctx::Stats;
+        } else if (top() == Ctx::Inventory) {
+            itemId.clear();
+            itemQuantity = 1;
+            next = Ctx::InventoryEntry;
+        } else if (top() == Ctx::Root && currentKey == "inventory") {
+            // A non-array inventory still clears the current one, like loadFromJson
+            save.inventory.emplace();
+        } else if (top() == Ctx::Flags || top() == Ctx::Stats) {
+            return fail("[json.exception.type_error.302] '" + currentKey + "' must be a scalar");
         }
+        stack.push_back(next);
+        return true;
     }
     
-    std::cout << "  -> Condition PASSED" << std::endl;
-    return true;
-}
-
-// Apply effects from story choices
-void GameStateManager::applyEffects(const Effects& effects, InventorySystem* inventory) {
-    // Add new flags
-    if (!effects.addFlag.empty()) {
-        flags[effects.addFlag] = true;
+    bool key(string_t& value) {
+        currentKey = value;
+        return true;
     }
     
-    // Remove/disable flags
-    if (!effects.removeFlag.empty()) {
-        flags[effects.removeFlag] = false;
+    bool end_object() {
+        if (top() == Ctx::InventoryEntry) {
+            save.inventory->emplace_back(itemId, itemQuantity);
+        }
+        stack.pop_back();
+        return true;
     }
     
-    // Modify numeric stats
-    for (const auto& [statName, modifier] : effects.modifyStats) {
-        stats[statName] += modifier;
+    bool start_array(std::size_t) {
+        Ctx next = Ctx::Skip;
+        if (top() == Ctx::Root && currentKey == "inventory") {
+            save.inventory.emplace();
+            next = Ctx::Inventory;
+        } else if (top() == Ctx::Flags || top() == Ctx::Stats) {
+            return fail("[json.exception.type_error.302] '" + currentKey + "' must be a scalar");
+        }
+        stack.push_back(next);
+        return true;
     }
     
-    // Add items to inventory
-    for (const auto& [itemId, quantity] : effects.addItems) {
-        if (inventory) {
-            inventory->addItem(itemId, quantity);
+    bool end_array() {
+        stack.pop_back();
+        return true;
+    }
+    
+    bool parse_error(std::size_t, const std::string&, const json::exception& e) {
+        return fail(e.what());
+    }
+
+private:
+    enum class Ctx { Root, Flags, Stats, Inventory, InventoryEntry, Skip };
+    
+    Ctx top() const { return stack.empty() ? Ctx::Skip : stack.back(); }
+    
+    bool number(long long value) {
+        switch (top()) {
+            case Ctx::Stats:
+                save.stats.push_back({intern(currentKey), static_cast<int>(value)});
+                return true;
+            case Ctx::InventoryEntry:
+                if (currentKey == "quantity") itemQuantity = static_cast<int>(value);
+                else if (currentKey == "id") return fail("[json.exception.type_error.302] item id must be a string");
+                return true;
+            default:
+                return scalar();
+        }
+    }
+    
+    bool scalar() {
+        switch (top()) {
+            case Ctx::Root:
+                if (currentKey == "currentScript" || currentKey == "currentScene") {
+                    return fail("[json.exception.type_error.302] " + currentKey + " must be a string");
+                }
+                if (currentKey == "inventory") {
+                    save.inventory.emplace();
+                }
+                return true;
+            case Ctx::Flags:
+                return fail("[json.exception.type_error.302] flag '" + currentKey + "' must be a boolean");
+            case Ctx::Stats:
+                return fail("[json.exception.type_error.302] stat '" + currentKey + "' must be a number");
+            default:
+                return true;
         }
     }
+    
+    bool fail(std::string message) {
+        errorMessage = std::move(message);
+        return false;
+    }
+    
+    SaveSnapshot& save;
+    std::vector<Ctx> stack;
+    std::string currentKey;
+    std::string errorMessage;
+    std::string itemId;
+    int itemQuantity = 1;
+};
+
+// What condition expressions read (see ConditionProgram::run)
+struct ConditionState {
+    const FlagSet& flags;
+    const std::unordered_map<Symbol, int>& stats;
+    const InventorySystem* inventory;
+
+    bool flag(Symbol name) const { return flags.get(name); }
+    int stat(Symbol name) const {
+        auto it = stats.find(name);
+        return it != stats.end() ? it->second : 0;
+    }
+    int items(Symbol name) const { return inventory ? inventory->getItemCount(name) : 0; }
+};
+
+// Points GameStateManager::pendingChanges at a change set for the life of an applyEffects call,
+// and clears it however the call ends
+class BatchScope {
+public:
+    BatchScope(EffectChanges*& slot, EffectChanges& changes) : slot(slot) { slot = &changes; }
+    ~BatchScope() { slot = nullptr; }
+    BatchScope(const BatchScope&) = delete;
+    BatchScope& operator=(const BatchScope&) = delete;
+
+private:
+    EffectChanges*& slot;
+};
 
-    // Remove items from inventory
-    for (const auto& [itemId, quantity] : effects.removeItems) {
-        if (inventory) {
-            inventory->removeItem(itemId, quantity, this);
+} // namespace
+
+GameStateManager::GameStateManager(int slot)
+    : slot(std::clamp(slot, 0, SaveSlots::SLOT_COUNT - 1)) {}
+
+// Apply effects from story choices
+EffectChanges GameStateManager::applyEffects(const Effects& effects, InventorySystem* inventory) {
+    EffectChanges changes;
+    {
+        BatchScope batch(pendingChanges, changes);
+        for (const EffectStep& step : effects.steps) {
+            switch (step.op) {
+                case EffectStep::Op::SetFlag:
+                    setFlag(step.target, true);
+                    break;
+                case EffectStep::Op::ClearFlag:
+                    setFlag(step.target, false);
+                    break;
+                case EffectStep::Op::AddStat: {
+                    stats[step.target] += step.amount;
+                    auto it = std::find_if(changes.stats.begin(), changes.stats.end(),
+                                           [&step](const auto& entry) { return entry.first == step.target; });
+                    if (it != changes.stats.end()) it->second += step.amount;
+                    else changes.stats.push_back({step.target, step.amount});
+                    break;
+                }
+                case EffectStep::Op::AddItem:
+                    if (inventory) inventory->addItem(step.target, step.amount);
+                    break;
+                case EffectStep::Op::RemoveItem:
+                    if (inventory) inventory->removeItem(step.target, step.amount);
+                    break;
+            }
         }
     }
+    
+    // Steps that cancelled out changed nothing
+    changes.stats.erase(std::remove_if(changes.stats.begin(), changes.stats.end(),
+                                       [](const auto& entry) { return entry.second == 0; }),
+                        changes.stats.end());
+    
+    // Commit: journal the net changes
+    for (const auto& [flag, value] : changes.flags) {
+        JournalRecord entry;
+        entry.type = JournalRecord::Type::SetFlag;
+        entry.key = flag;
+        entry.value = value ? 1 : 0;
+        record(entry);
+    }
+    for (const auto& [stat, delta] : changes.stats) {
+        JournalRecord entry;
+        entry.type = JournalRecord::Type::AddStat;
+        entry.key = stat;
+        entry.value = delta;
+        record(entry);
+    }
+    for (const InventoryChange& change : changes.items) {
+        recordInventoryChange(change);
+    }
+    return changes;
+}
+
+bool GameStateManager::checkCondition(const Condition& condition, const InventorySystem* inventory) const {
+    if (!flags.matches(condition.compiled)) {
+        return false;
+    }
+    return condition.program.empty() || condition.program.run(ConditionState{flags, stats, inventory});
+}
+
+void GameStateManager::setFlag(Symbol flag, bool value) {
+    if (flag == NO_SYMBOL || (flags.contains(flag) && flags.get(flag) == value)) {
+        return;
+    }
+    flags.set(flag, value);
+    if (pendingChanges) {
+        auto it = std::find_if(pendingChanges->flags.begin(), pendingChanges->flags.end(),
+                               [flag](const auto& entry) { return entry.first == flag; });
+        if (it != pendingChanges->flags.end()) it->second = value;
+        else pendingChanges->flags.push_back({flag, value});
+        return;
+    }
+    JournalRecord change;
+    change.type = JournalRecord::Type::SetFlag;
+    change.key = flag;
+    change.value = value ? 1 : 0;
+    record(change);
+}
+
+void GameStateManager::recordInventoryChange(const InventoryChange& change) {
+    if (pendingChanges) {
+        pendingChanges->items.push_back(change);
+        return;
+    }
+    JournalRecord entry;
+    switch (change.kind) {
+        case InventoryChange::Kind::Add:
+            entry.type = JournalRecord::Type::AddItem;
+            entry.key = change.itemId;
+            break;
+        case InventoryChange::Kind::Remove:
+            entry.type = JournalRecord::Type::RemoveItem;
+            entry.key = change.itemId;
+            break;
+        case InventoryChange::Kind::RemoveAt:
+            entry.type = JournalRecord::Type::RemoveItemAt;
+            entry.index = change.index;
+            break;
+    }
+    entry.value = change.quantity;
+    record(entry);
+}
+
+void GameStateManager::record(const JournalRecord& entry) {
+    if (replaying || !writer().isJournaling()) {
+        return;
+    }
+    SaveFormat::appendRecord(journal, entry);
+    ++journalEntries;
+}
+
+void GameStateManager::submitSnapshot(const InventorySystem* inventory) {
+    writer().submit(snapshot(inventory));
+    journal.clear();
+    journalEntries = 0;
+    snapshotWritten = true;
 }
 
-// Save game state to JSON file
+SaveState GameStateManager::snapshot(const InventorySystem* inventory) const {
+    SaveState state;
+    state.currentScript = currentScript;
+    state.currentScene = currentScene;
+    state.flags.reserve(flags.size());
+    flags.forEach([&state](Symbol flag, bool value) { state.flags.push_back({flag, value}); });
+    state.stats.assign(stats.begin(), stats.end());
+    if (inventory) {
+        state.inventory = inventory->getItems();
+    }
+    return state;
+}
+
+// Queue a save; serialization and disk I/O happen on the save writer, off this thread
 void GameStateManager::saveGame(const std::string& scriptId, const std::string& sceneId,
                                 const InventorySystem* inventory) {
-    using json = nlohmann::json;
-    
     // Update current location
-    currentScript = scriptId;
-    currentScene = sceneId;
+    if (scriptId != currentScript || sceneId != currentScene) {
+        currentScript = scriptId;
+        currentScene = sceneId;
+        JournalRecord location;
+        location.type = JournalRecord::Type::Location;
+        location.script = scriptId;
+        location.scene = sceneId;
+        record(location);
+    }
     
-    // Build JSON save data
-    json saveData;
-    saveData["playerName"] = "";
-    saveData["currentScript"] = scriptId;
-    saveData["currentScene"] = sceneId;
+    updateSlotInfo();
     
-    // Save flags
-    json flagsJson = json::object();
-    for (const auto& [key, value] : flags) {
-        flagsJson[key] = value;
+    SaveWriter& slotWriter = writer();
+    if (!slotWriter.isJournaling()) {
+        slotWriter.submit(snapshot(inventory));
+        return;
     }
-    saveData["flags"] = flagsJson;
     
-    // Save stats
-    json statsJson = json::object();
-    for (const auto& [key, value] : stats) {
-        statsJson[key] = value;
+    // The journal on disk may end in a torn record or belong to another session's
+    // snapshot, so each session starts its own before appending
+    if (!snapshotWritten || journalEntries >= JOURNAL_COMPACT_EVERY) {
+        submitSnapshot(inventory);
+    } else if (!journal.empty()) {
+        slotWriter.append(std::move(journal));
+        journal.clear();
     }
-    saveData["stats"] = statsJson;
-    
-    // Save inventory
-    if (inventory) {
-        inventory->saveToJson(saveData);
+}
+
+void GameStateManager::compactSave(const InventorySystem* inventory) {
+    if (journalEntries > 0) {
+        submitSnapshot(inventory);
     }
-    
-    // Write to file
-    std::ofstream file("assets/save_data.json");
-    if (file.is_open()) {
-        file << saveData.dump(2);
-        file.close();
-        std::cout << "Game saved: " << scriptId << " - " << sceneId << std::endl;
-    } else {
-        std::cerr << "Failed to save game" << std::endl;
+    if (hasSaveData()) {
+        updateSlotInfo();
     }
 }
 
+void GameStateManager::setScriptDetails(const std::string& title, int chapter) {
+    scriptTitle = title;
+    this->chapter = chapter;
+}
+
+void GameStateManager::updateSlotInfo() {
+    SlotInfo info;
+    info.used = true;
+    info.scriptId = currentScript;
+    info.scriptTitle = scriptTitle;
+    info.chapter = chapter;
+    info.sceneId = currentScene;
+    info.playtimeSeconds = static_cast<std::uint32_t>(playtime);
+    info.savedAt = static_cast<std::int64_t>(std::time(nullptr));
+    SaveSlots::global().update(slot, std::move(info));
+}
+
 // Load game state from JSON file
-void GameStateManager::loadGame(InventorySystem* inventory) {
-    using json = nlohmann::json;
+void GameStateManager::loadGame(InventorySystem* inventory, JsonParseMode mode) {
+    // Read back whatever was last saved, not what happened to be on disk
+    SaveWriter& slotWriter = writer();
+    slotWriter.flush();
+    playtime = SaveSlots::global().getSlot(slot).playtimeSeconds;
+    
+    // The single save from before slots (binary or older JSON) is read into the first
+    // slot once, then rewritten there
+    std::string path = slotWriter.getPath();
+    std::string journalPath = slotWriter.getJournalPath();
+    std::error_code ec;
+    bool legacy = false;
+    if (slot == 0 && !std::filesystem::exists(path, ec)) {
+        if (std::filesystem::exists(SaveFormat::kLegacyBinaryPath, ec)) {
+            path = SaveFormat::kLegacyBinaryPath;
+            journalPath = SaveFormat::kLegacyJournalPath;
+            legacy = true;
+        } else if (std::filesystem::exists(SaveFormat::kLegacyJsonPath, ec)) {
+            path = SaveFormat::kLegacyJsonPath;
+            legacy = true;
+        }
+    }
     
-    std::ifstream file("assets/save_data.json");
-    if (!file.is_open()) {
+    auto fileSize = std::filesystem::file_size(path, ec);
+    if (ec) {
         std::cout << "No save file found, starting fresh" << std::endl;
         return;
     }
+    if (fileSize == 0) {
+        std::cout << "Save file is empty, starting fresh" << std::endl;
+        return;
+    }
     
-    try {
-        // Check if file is empty
-        file.seekg(0, std::ios::end);
-        if (file.tellg() == 0) {
-            std::cout << "Save file is empty, starting fresh" << std::endl;
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cout << "No save file found, starting fresh" << std::endl;
+        return;
+    }
+    
+    // Binary saves carry CBOR behind a checked header; legacy saves are JSON text
+    const std::uint8_t* data = file.data();
+    std::size_t size = file.size();
+    auto format = nlohmann::json::input_format_t::json;
+    std::optional<std::uint32_t> snapshotChecksum;
+    if (SaveFormat::isBinary(data, size)) {
+        SaveFormat::Payload payload;
+        std::string error;
+        if (!SaveFormat::decode(data, size, payload, error)) {
+            std::cerr << "Failed to load save data: " << error << std::endl;
+            std::cout << "Starting fresh due to corrupted save" << std::endl;
             return;
         }
-        file.seekg(0, std::ios::beg);
-        
-        json saveData;
-        file >> saveData;
+        data = payload.data;
+        size = payload.size;
+        format = nlohmann::json::input_format_t::cbor;
+        snapshotChecksum = payload.checksum;
+    }
+    
+    bool loaded = mode == JsonParseMode::Dom ? loadGameDom(data, size, format, inventory)
+                                             : loadGameStreaming(data, size, format, inventory);
+    if (loaded && snapshotChecksum) {
+        replayJournal(journalPath, *snapshotChecksum, inventory);
+    }
+    if (loaded && legacy) {
+        std::cout << "Moving " << path << " to " << slotWriter.getPath() << std::endl;
+        submitSnapshot(inventory);
+    }
+}
+
+void GameStateManager::replayJournal(const std::string& path, std::uint32_t baseChecksum,
+                                     InventorySystem* inventory) {
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        return;
+    }
+    MappedFile file;
+    if (!file.open(path)) {
+        return;
+    }
+    
+    std::vector<JournalRecord> records;
+    std::string error;
+    if (!SaveFormat::readJournal(file.data(), file.size(), baseChecksum, records, error)) {
+        std::cout << "Ignoring save journal: " << error << std::endl;
+        return;
+    }
+    if (!error.empty()) {
+        std::cerr << "Save journal damaged, " << error << std::endl;
+    }
+    
+    // Item changes re-fire the held-item flag bindings; those flags are journaled too
+    replaying = true;
+    for (const JournalRecord& entry : records) {
+        switch (entry.type) {
+            case JournalRecord::Type::SetFlag:
+                flags.set(entry.key, entry.value != 0);
+                break;
+            case JournalRecord::Type::AddStat:
+                stats[entry.key] += entry.value;
+                break;
+            case JournalRecord::Type::AddItem:
+                if (inventory) inventory->addItem(entry.key, entry.value);
+                break;
+            case JournalRecord::Type::RemoveItem:
+                if (inventory) inventory->removeItem(entry.key, entry.value);
+                break;
+            case JournalRecord::Type::RemoveItemAt:
+                if (inventory) inventory->removeItemAtIndex(entry.index, entry.value);
+                break;
+            case JournalRecord::Type::Location:
+                currentScript = entry.script;
+                currentScene = entry.scene;
+                break;
+        }
+    }
+    replaying = false;
+    
+    std::cout << "Replayed " << records.size() << " journal records: " << currentScript << " - " << currentScene << std::endl;
+}
+
+bool GameStateManager::loadGameDom(const std::uint8_t* data, std::size_t size,
+                                   nlohmann::json::input_format_t format, InventorySystem* inventory) {
+    using json = nlohmann::json;
+    
+    try {
+        json saveData = format == json::input_format_t::cbor ? json::from_cbor(data, data + size)
+                                                             : json::parse(data, data + size);
         
         // Load current script/scene
         if (saveData.contains("currentScript")) {
@@ -158,14 +540,14 @@ void GameStateManager::loadGame(InventorySystem* inventory) {
         // Load flags
         if (saveData.contains("flags") && saveData["flags"].is_object()) {
             for (auto& [key, value] : saveData["flags"].items()) {
-                flags[key] = value;
+                flags.set(intern(key), value.get<bool>());
             }
         }
         
         // Load stats
         if (saveData.contains("stats") && saveData["stats"].is_object()) {
             for (auto& [key, value] : saveData["stats"].items()) {
-                stats[key] = value;
+                stats[intern(key)] = value;
             }
         }
         
@@ -175,20 +557,49 @@ void GameStateManager::loadGame(InventorySystem* inventory) {
         }
         
         std::cout << "Game loaded: " << currentScript << " - " << currentScene << std::endl;
+        return true;
     } catch (const json::exception& e) {
         std::cerr << "Failed to load save data: " << e.what() << std::endl;
         std::cout << "Starting fresh due to corrupted save" << std::endl;
+        return false;
+    }
+}
+
+bool GameStateManager::loadGameStreaming(const std::uint8_t* data, std::size_t size,
+                                         nlohmann::json::input_format_t format, InventorySystem* inventory) {
+    SaveSnapshot save;
+    SaveSaxHandler handler(save);
+    if (!json::sax_parse(data, data + size, &handler, format)) {
+        std::cerr << "Failed to load save data: " << handler.error() << std::endl;
+        std::cout << "Starting fresh due to corrupted save" << std::endl;
+        return false;
+    }
+    
+    if (save.currentScript) {
+        currentScript = std::move(*save.currentScript);
+    }
+    if (save.currentScene) {
+        currentScene = std::move(*save.currentScene);
     }
+    for (const auto& [flag, value] : save.flags) {
+        flags.set(flag, value);
+    }
+    for (const auto& [stat, value] : save.stats) {
+        stats[stat] = value;
+    }
+    if (inventory && save.inventory) {
+        inventory->loadFromEntries(*save.inventory);
+    }
+    
+    std::cout << "Game loaded: " << currentScript << " - " << currentScene << std::endl;
+    return true;
 }
 
 // Clear save data and reset to beginning (preserves intro_complete flag)
 void GameStateManager::clearSave() {
     // Preserve intro_complete flag
-    bool preservedIntroComplete = false;
-    auto it = flags.find("intro_complete");
-    if (it != flags.end()) {
-        preservedIntroComplete = it->second;
-    }
+    static const Symbol INTRO_COMPLETE = intern("intro_complete");
+    bool preservedIntroComplete = flags.get(INTRO_COMPLETE);
 
     // Reset in-memory state
     flags.clear();
@@ -198,30 +609,17 @@ void GameStateManager::clearSave() {
 
     // Restore intro_complete flag if it existed
     if (preservedIntroComplete) {
-        flags["intro_complete"] = true;
+        flags.set(INTRO_COMPLETE, true);
     }
 
-    // Save reset state to file
-    using json = nlohmann::json;
-    json saveData;
-    saveData["playerName"] = "";
-    saveData["currentScript"] = "";
-    saveData["currentScene"] = "a1_s01_mythic_void";
-    
-    json flagsJson = json::object();
-    for (const auto& [key, value] : flags) {
-        flagsJson[key] = value;
-    }
-    saveData["flags"] = flagsJson;
-    saveData["stats"] = json::object();
-    saveData["inventory"] = json::array();
-
-    std::ofstream file("assets/save_data.json", std::ios::trunc);
-    if (file.is_open()) {
-        file << saveData.dump(2);
-        file.close();
-        std::cout << "Save data reset to beginning (intro_complete preserved)" << std::endl;
-    } else {
-        std::cerr << "Failed to reset save data file" << std::endl;
-    }
-}
\ No newline at end of file
+    // Save reset state to file (queued behind any pending save, so it cannot be overwritten)
+    SaveState state = snapshot(nullptr);
+    state.currentScene = "a1_s01_mythic_void";
+    writer().submit(std::move(state));
+    SaveSlots::global().clear(slot);
+    playtime = 0;
+    journal.clear();
+    journalEntries = 0;
+    snapshotWritten = true;
+    std::cout << "Save data reset to beginning (intro_complete preserved)" << std::endl;
+}
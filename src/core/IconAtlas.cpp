@@ -0,0 +1,71 @@
+#include "IconAtlas.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+void IconAtlas::reset(const std::vector<Symbol>& ids) {
+    slots.clear();
+    rects.clear();
+    texture.reset();
+
+    // Slots on a near-square grid below a strip holding the white block
+    const unsigned slot = ICON_SIZE + GAP;
+    const unsigned top = WHITE_SIZE + GAP;
+    const unsigned maxColumns = (MAX_SIZE - GAP) / slot;
+    const unsigned maxRows = (MAX_SIZE - top) / slot;
+    const unsigned count = static_cast<unsigned>(ids.size());
+    unsigned columns = std::clamp(static_cast<unsigned>(std::ceil(std::sqrt(static_cast<double>(count)))), 1u, maxColumns);
+    unsigned rows = std::min((count + columns - 1) / columns, maxRows);
+    if (count > columns * rows) {
+        std::cerr << "Icon atlas full: " << count - columns * rows << " of " << count << " icons left out" << std::endl;
+    }
+
+    pageSize = {GAP + columns * slot, top + std::max(rows, 1u) * slot};
+    for (unsigned index = 0; index < std::min(count, columns * rows); ++index) {
+        slots[ids[index]] = {GAP + (index % columns) * slot, top + (index / columns) * slot};
+    }
+}
+
+bool IconAtlas::createTexture() {
+    sf::Image pixels(pageSize, sf::Color::Transparent);
+    for (unsigned y = 0; y < WHITE_SIZE; ++y) {
+        for (unsigned x = 0; x < WHITE_SIZE; ++x) {
+            pixels.setPixel({x, y}, sf::Color::White);
+        }
+    }
+
+    sf::Texture created;
+    if (!created.loadFromImage(pixels)) {
+        std::cerr << "Failed to create icon atlas" << std::endl;
+        return false;
+    }
+    created.setSmooth(true);
+    texture = std::move(created);
+    return true;
+}
+
+bool IconAtlas::upload(Symbol id, const sf::Image& icon) {
+    auto slot = slots.find(id);
+    sf::Vector2u size = icon.getSize();
+    if (slot == slots.end()) {
+        return false;
+    }
+    if (size.x == 0 || size.y == 0 || size.x > ICON_SIZE || size.y > ICON_SIZE) {
+        std::cerr << "Icon for " << symbolName(id) << " skipped: not fitted to " << ICON_SIZE << "px" << std::endl;
+        return false;
+    }
+    if (!texture && !createTexture()) {
+        return false;
+    }
+
+    // Centred in the slot
+    sf::Vector2u position(slot->second.x + (ICON_SIZE - size.x) / 2, slot->second.y + (ICON_SIZE - size.y) / 2);
+    texture->update(icon, position);
+    rects[id] = sf::IntRect(sf::Vector2i(position), sf::Vector2i(size));
+    return true;
+}
+
+const sf::IntRect* IconAtlas::getRect(Symbol id) const {
+    auto it = rects.find(id);
+    return it != rects.end() ? &it->second : nullptr;
+}
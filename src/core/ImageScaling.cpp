@@ -0,0 +1,159 @@
+#include "ImageScaling.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UAG_IMAGE_SCALING_SSE2 1
+#endif
+
+namespace ImageScaling {
+
+namespace {
+
+// Source range [begin, end) covered by each destination index
+struct Span {
+    std::uint32_t begin;
+    std::uint32_t end;
+};
+
+std::vector<Span> coverage(std::uint32_t source, std::uint32_t target) {
+    std::vector<Span> spans(target);
+    for (std::uint32_t i = 0; i < target; ++i) {
+        std::uint32_t begin = static_cast<std::uint32_t>(static_cast<std::uint64_t>(i) * source / target);
+        std::uint32_t end = static_cast<std::uint32_t>(static_cast<std::uint64_t>(i + 1) * source / target);
+        spans[i] = {begin, std::max(end, begin + 1)};
+    }
+    return spans;
+}
+
+// Rounded average; the SIMD paths compute exactly the same thing four lanes at a time
+inline std::uint8_t average(std::uint32_t sum, float inverseCount) {
+    return static_cast<std::uint8_t>(static_cast<float>(sum) * inverseCount + 0.5f);
+}
+
+// Average each run of source pixels in a row into one destination pixel
+void averageRow(const std::uint8_t* in, std::uint8_t* out, const std::vector<Span>& columns) {
+    for (std::size_t x = 0; x < columns.size(); ++x) {
+        const Span span = columns[x];
+        const float inverseCount = 1.f / static_cast<float>(span.end - span.begin);
+#ifdef UAG_IMAGE_SCALING_SSE2
+        // One RGBA pixel per 32-bit lane group: widen to 4 x u32 and accumulate
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sum = zero;
+        for (std::uint32_t sx = span.begin; sx < span.end; ++sx) {
+            std::int32_t pixel;
+            std::memcpy(&pixel, in + sx * 4, 4);
+            __m128i wide = _mm_unpacklo_epi8(_mm_cvtsi32_si128(pixel), zero);
+            sum = _mm_add_epi32(sum, _mm_unpacklo_epi16(wide, zero));
+        }
+        __m128 scaled = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(sum), _mm_set1_ps(inverseCount)), _mm_set1_ps(0.5f));
+        __m128i packed = _mm_cvttps_epi32(scaled);
+        packed = _mm_packs_epi32(packed, packed);
+        packed = _mm_packus_epi16(packed, packed);
+        std::int32_t result = _mm_cvtsi128_si32(packed);
+        std::memcpy(out + x * 4, &result, 4);
+#else
+        std::uint32_t sum[4] = {0, 0, 0, 0};
+        for (std::uint32_t sx = span.begin; sx < span.end; ++sx) {
+            for (int c = 0; c < 4; ++c) {
+                sum[c] += in[sx * 4 + c];
+            }
+        }
+        for (int c = 0; c < 4; ++c) {
+            out[x * 4 + c] = average(sum[c], inverseCount);
+        }
+#endif
+    }
+}
+
+// sums[i] += row[i] for a whole row of bytes
+void accumulateRow(const std::uint8_t* row, std::uint32_t* sums, std::size_t count) {
+    std::size_t i = 0;
+#ifdef UAG_IMAGE_SCALING_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        __m128i* target = reinterpret_cast<__m128i*>(sums + i);
+        _mm_storeu_si128(target + 0, _mm_add_epi32(_mm_loadu_si128(target + 0), _mm_unpacklo_epi16(low, zero)));
+        _mm_storeu_si128(target + 1, _mm_add_epi32(_mm_loadu_si128(target + 1), _mm_unpackhi_epi16(low, zero)));
+        _mm_storeu_si128(target + 2, _mm_add_epi32(_mm_loadu_si128(target + 2), _mm_unpacklo_epi16(high, zero)));
+        _mm_storeu_si128(target + 3, _mm_add_epi32(_mm_loadu_si128(target + 3), _mm_unpackhi_epi16(high, zero)));
+    }
+#endif
+    for (; i < count; ++i) {
+        sums[i] += row[i];
+    }
+}
+
+// out[i] = rounded sums[i] / count
+void divideRow(const std::uint32_t* sums, std::uint8_t* out, std::size_t count, float inverseCount) {
+    std::size_t i = 0;
+#ifdef UAG_IMAGE_SCALING_SSE2
+    const __m128 scale = _mm_set1_ps(inverseCount);
+    const __m128 half = _mm_set1_ps(0.5f);
+    auto lanes = [&](std::size_t offset) {
+        __m128 value = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sums + offset)));
+        return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half));
+    };
+    for (; i + 16 <= count; i += 16) {
+        __m128i low = _mm_packs_epi32(lanes(i), lanes(i + 4));
+        __m128i high = _mm_packs_epi32(lanes(i + 8), lanes(i + 12));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(low, high));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = average(sums[i], inverseCount);
+    }
+}
+
+} // namespace
+
+Size fitWithin(Size source, Size maxSize) {
+    if (maxSize.width == 0 || maxSize.height == 0 || source.width == 0 || source.height == 0 ||
+        (source.width <= maxSize.width && source.height <= maxSize.height)) {
+        return source;
+    }
+
+    // Scale by whichever side is the tighter fit
+    std::uint64_t widthFromHeight = static_cast<std::uint64_t>(source.width) * maxSize.height / source.height;
+    if (widthFromHeight <= maxSize.width) {
+        return {std::max<std::uint32_t>(1, static_cast<std::uint32_t>(widthFromHeight)), maxSize.height};
+    }
+    std::uint64_t heightFromWidth = static_cast<std::uint64_t>(source.height) * maxSize.width / source.width;
+    return {maxSize.width, std::max<std::uint32_t>(1, static_cast<std::uint32_t>(heightFromWidth))};
+}
+
+std::vector<std::uint8_t> downscaleBox(const std::uint8_t* rgba, Size source, Size target) {
+    if (target.width >= source.width && target.height >= source.height) {
+        return std::vector<std::uint8_t>(rgba, rgba + static_cast<std::size_t>(source.width) * source.height * 4);
+    }
+    target.width = std::min(target.width, source.width);
+    target.height = std::min(target.height, source.height);
+
+    // Separable: average along rows into a narrow intermediate, then down the columns
+    std::vector<Span> columns = coverage(source.width, target.width);
+    std::vector<Span> rows = coverage(source.height, target.height);
+
+    const std::size_t rowBytes = static_cast<std::size_t>(target.width) * 4;
+    std::vector<std::uint8_t> narrow(rowBytes * source.height);
+    for (std::uint32_t y = 0; y < source.height; ++y) {
+        averageRow(rgba + static_cast<std::size_t>(y) * source.width * 4, narrow.data() + y * rowBytes, columns);
+    }
+
+    std::vector<std::uint8_t> result(rowBytes * target.height);
+    std::vector<std::uint32_t> sums(rowBytes);
+    for (std::uint32_t y = 0; y < target.height; ++y) {
+        std::fill(sums.begin(), sums.end(), 0);
+        for (std::uint32_t sy = rows[y].begin; sy < rows[y].end; ++sy) {
+            accumulateRow(narrow.data() + sy * rowBytes, sums.data(), rowBytes);
+        }
+        divideRow(sums.data(), result.data() + y * rowBytes, rowBytes, 1.f / static_cast<float>(rows[y].end - rows[y].begin));
+    }
+    return result;
+}
+
+} // namespace ImageScaling
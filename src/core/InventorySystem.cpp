@@ -1,184 +1,86 @@
 #include "InventorySystem.h"
-#include "GameStateManager.h"
-#include <fstream>
+#include <algorithm>
 #include <iostream>
 
-InventorySystem::InventorySystem(ResourceManager& resources)
-    : resources(resources)
+InventorySystem::InventorySystem(ItemRegistry& registry)
+    : registry(registry)
 {
-    loadItemDefinitions();
+    registry.load();
 }
 
-// Parse items.json and preload textures
-bool InventorySystem::loadItemDefinitions() {
-    using json = nlohmann::json;
-    
-    std::ifstream file("assets/items/items.json");
-    if (!file.is_open()) {
-        std::cerr << "Failed to load item definitions" << std::endl;
-        return false;
-    }
-    
-    try {
-        json itemsJson;
-        file >> itemsJson;
-        
-        // Parse each item definition
-        for (auto& [itemId, itemData] : itemsJson.items()) {
-            ItemDefinition def;
-            def.id = itemId;
-            def.name = itemData.value("name", itemId);
-            def.description = itemData.value("description", "");
-            def.texturePath = itemData.value("texture", "");
-            def.stackable = itemData.value("stackable", true);
-            def.maxStackSize = itemData.value("maxStackSize", 99);
-            
-            itemDefinitions[itemId] = def;
-            
-            // Preload texture for this item
-            if (!def.texturePath.empty()) {
-                resources.loadTexture(itemId, def.texturePath);
-            }
-        }
-        
-        std::cout << "Loaded " << itemDefinitions.size() << " item definitions" << std::endl;
-        return true;
-    }
-    catch (const json::exception& e) {
-        std::cerr << "Failed to parse item definitions: " << e.what() << std::endl;
-        return false;
-    }
-}
-
-const ItemDefinition* InventorySystem::getItemDefinition(const std::string& itemId) const {
-    auto it = itemDefinitions.find(itemId);
-    if (it != itemDefinitions.end()) {
-        return &it->second;
-    }
-    return nullptr;
+const ItemDefinition* InventorySystem::getItemDefinition(Symbol itemId) const {
+    return registry.find(itemId);
 }
 
 // Add items with intelligent stacking behavior
-bool InventorySystem::addItem(const std::string& itemId, int quantity) {
+bool InventorySystem::addItem(Symbol itemId, int quantity) {
     const ItemDefinition* def = getItemDefinition(itemId);
     if (!def) {
-        std::cerr << "Item not found: " << itemId << std::endl;
+        std::cerr << "Item not found: " << symbolName(itemId) << std::endl;
         return false;
     }
     
-    int remainingQuantity = quantity;
-    
-    if (def->stackable) {
-        // First, try to fill existing stacks
-        for (auto& item : items) {
-            if (item.id == itemId && item.quantity < def->maxStackSize) {
-                int canAdd = std::min(remainingQuantity, def->maxStackSize - item.quantity);
-                item.quantity += canAdd;
-                remainingQuantity -= canAdd;
-                
-                if (remainingQuantity <= 0) {
-                    return true;
-                }
-            }
-        }
+    bool wasHeld = hasItem(itemId);
+    items.add(itemId, quantity, def->maxStackSize, def->stackable);
+    if (!wasHeld && hasItem(itemId)) {
+        notifyHeldChanged(itemId, true);
     }
-    
-    // Create new stacks for remaining quantity
-    while (remainingQuantity > 0) {
-        int stackSize = def->stackable ? std::min(remainingQuantity, def->maxStackSize) : 1;
-        items.emplace_back(itemId, stackSize);
-        remainingQuantity -= stackSize;
+    if (quantity > 0) {
+        notifyChanged({InventoryChange::Kind::Add, itemId, -1, quantity});
     }
-    
     return true;
 }
 
-// Remove items and update game state flags when fully removed
-bool InventorySystem::removeItem(const std::string& itemId, int quantity, GameStateManager* gameState) {
-    int remainingQuantity = quantity;
-    
-    // Remove from stacks until quantity is satisfied
-    for (auto it = items.begin(); it != items.end();) {
-        if (it->id == itemId) {
-            if (it->quantity <= remainingQuantity) {
-                remainingQuantity -= it->quantity;
-                it = items.erase(it);
-            } else {
-                it->quantity -= remainingQuantity;
-                remainingQuantity = 0;
-                break;
-            }
-            
-            if (remainingQuantity <= 0) {
-                // Update game state when item is completely removed
-                if (gameState && !hasItem(itemId)) {
-                    if (itemId == "asgard_sword") {
-                        gameState->setFlag("has_asgard_sword", false);
-                    } else if (itemId == "bronze_key") {
-                        gameState->setFlag("has_bronze_key", false);
-                    }
-                }
-                return true;
-            }
-        } else {
-            ++it;
-        }
+bool InventorySystem::removeItem(Symbol itemId, int quantity) {
+    int removed = items.remove(itemId, quantity);
+    if (removed > 0 && !hasItem(itemId)) {
+        notifyHeldChanged(itemId, false);
     }
-    
-    // Final check to update game state
-    if (gameState && remainingQuantity == 0 && !hasItem(itemId)) {
-        if (itemId == "asgard_sword") {
-            gameState->setFlag("has_asgard_sword", false);
-        } else if (itemId == "bronze_key") {
-            gameState->setFlag("has_bronze_key", false);
-        }
+    if (removed > 0) {
+        notifyChanged({InventoryChange::Kind::Remove, itemId, -1, removed});
     }
-    
-    return remainingQuantity == 0;
+    return removed == quantity;
 }
 
 // Remove item at specific inventory slot
-void InventorySystem::removeItemAtIndex(int index, int quantity, GameStateManager* gameState) {
-    if (index < 0 || index >= static_cast<int>(items.size())) {
+void InventorySystem::removeItemAtIndex(int index, int quantity) {
+    const auto& stacks = items.getStacks();
+    if (index < 0 || static_cast<std::size_t>(index) >= stacks.size()) {
         return;
     }
     
-    std::string itemId = items[index].id;
-    
-    if (items[index].quantity <= quantity) {
-        items.erase(items.begin() + index);
-    } else {
-        items[index].quantity -= quantity;
+    // Report what was actually taken, not what was asked for
+    int taken = std::clamp(quantity, 0, stacks[index].quantity);
+    if (taken == 0) {
+        return;
     }
-    
-    // Update game state if item is completely removed
-    if (gameState && !hasItem(itemId)) {
-        if (itemId == "asgard_sword") {
-            gameState->setFlag("has_asgard_sword", false);
-        } else if (itemId == "bronze_key") {
-            gameState->setFlag("has_bronze_key", false);
-        }
+    Symbol itemId = items.removeAt(static_cast<std::size_t>(index), taken);
+    if (!hasItem(itemId)) {
+        notifyHeldChanged(itemId, false);
     }
+    notifyChanged({InventoryChange::Kind::RemoveAt, itemId, index, taken});
 }
 
-bool InventorySystem::hasItem(const std::string& itemId) const {
-    for (const auto& item : items) {
-        if (item.id == itemId) {
+bool InventorySystem::holdsItemWithFlag(Symbol flag) const {
+    for (Symbol itemId : registry.getItemsWithFlag(flag)) {
+        if (hasItem(itemId)) {
             return true;
         }
     }
     return false;
 }
 
-// Sum quantities across all stacks of an item
-int InventorySystem::getItemCount(const std::string& itemId) const {
-    int count = 0;
-    for (const auto& item : items) {
-        if (item.id == itemId) {
-            count += item.quantity;
-        }
+void InventorySystem::notifyHeldChanged(Symbol itemId, bool held) {
+    const ItemDefinition* def = getItemDefinition(itemId);
+    if (onHeldChanged && def) {
+        onHeldChanged(*def, held);
+    }
+}
+
+void InventorySystem::notifyChanged(const InventoryChange& change) {
+    if (onChanged) {
+        onChanged(change);
     }
-    return count;
 }
 
 // Serialize inventory to JSON for saving
@@ -186,9 +88,9 @@ void InventorySystem::saveToJson(nlohmann::json& saveData) const {
     using json = nlohmann::json;
     
     json inventoryJson = json::array();
-    for (const auto& item : items) {
+    for (const auto& item : items.getStacks()) {
         json itemJson;
-        itemJson["id"] = item.id;
+        itemJson["id"] = std::string(symbolName(item.id));
         itemJson["quantity"] = item.quantity;
         inventoryJson.push_back(itemJson);
     }
@@ -204,13 +106,21 @@ void InventorySystem::loadFromJson(const nlohmann::json& saveData) {
         return;
     }
     
+    std::vector<std::pair<std::string, int>> entries;
     for (const auto& itemJson : saveData["inventory"]) {
-        std::string id = itemJson.value("id", "");
-        int quantity = itemJson.value("quantity", 1);
-        
+        entries.emplace_back(itemJson.value("id", ""), itemJson.value("quantity", 1));
+    }
+    loadFromEntries(entries);
+}
+
+void InventorySystem::loadFromEntries(const std::vector<std::pair<std::string, int>>& entries) {
+    items.clear();
+    
+    for (const auto& [id, quantity] : entries) {
         // Only load items that have valid definitions
-        if (!id.empty() && getItemDefinition(id)) {
-            items.emplace_back(id, quantity);
+        Symbol itemId = SymbolTable::global().find(id);
+        if (!id.empty() && getItemDefinition(itemId)) {
+            items.append(itemId, quantity);
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "ItemRegistry.h"
+#include "ResourceManager.h"
+#include "ThreadPool.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+ItemRegistry::ItemRegistry(ResourceManager& resources) : resources(resources) {}
+
+ItemRegistry::~ItemRegistry() {
+    // Decodes read through resources, which is destroyed after us
+    for (auto& [id, image] : pendingIcons) {
+        image.wait();
+    }
+}
+
+// Parse items.json and lay out the icon atlas (icons themselves load on first display)
+bool ItemRegistry::load() {
+    using json = nlohmann::json;
+    if (loaded) {
+        return true;
+    }
+    
+    const std::string path = "assets/items/items.json";
+    auto packed = resources.getPack().find(path);
+    std::ifstream file;
+    if (!packed) {
+        file.open(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to load item definitions" << std::endl;
+            return false;
+        }
+    }
+    
+    try {
+        json itemsJson = packed ? json::parse(packed->data, packed->data + packed->size) : json::parse(file);
+        
+        std::vector<Symbol> icons;
+        for (auto& [itemId, itemData] : itemsJson.items()) {
+            ItemDefinition def;
+            def.id = intern(itemId);
+            def.name = itemData.value("name", itemId);
+            def.description = itemData.value("description", "");
+            
+            // "texture" is an asset id (defaults to items/<id>); a plain path still works for items not in the manifest
+            std::string texture = itemData.value("texture", "");
+            const AssetInfo* asset = resources.getManifest().find(texture.empty() ? "items/" + itemId : texture);
+            def.texturePath = asset ? asset->path : texture;
+            def.stackable = itemData.value("stackable", true);
+            def.maxStackSize = itemData.value("maxStackSize", 99);
+            
+            // Flags derived from holding the item, e.g. "flags": ["has_bronze_key"]
+            if (itemData.contains("flags") && itemData["flags"].is_array()) {
+                for (const auto& flag : itemData["flags"]) {
+                    if (flag.is_string()) {
+                        def.flags.push_back(intern(flag.get<std::string>()));
+                        flagItems[def.flags.back()].push_back(def.id);
+                    }
+                }
+            }
+            
+            if (!def.texturePath.empty()) {
+                icons.push_back(def.id);
+            }
+            definitions[def.id] = def;
+        }
+        iconAtlas.reset(icons);
+        loaded = true;
+        
+        std::cout << "Loaded " << definitions.size() << " item definitions" << std::endl;
+        return true;
+    }
+    catch (const json::exception& e) {
+        std::cerr << "Failed to parse item definitions: " << e.what() << std::endl;
+        definitions.clear();
+        flagItems.clear();
+        return false;
+    }
+}
+
+const ItemDefinition* ItemRegistry::find(Symbol itemId) const {
+    auto it = definitions.find(itemId);
+    return it != definitions.end() ? &it->second : nullptr;
+}
+
+const std::vector<Symbol>& ItemRegistry::getItemsWithFlag(Symbol flag) const {
+    static const std::vector<Symbol> none;
+    auto it = flagItems.find(flag);
+    return it != flagItems.end() ? it->second : none;
+}
+
+const sf::IntRect* ItemRegistry::getIcon(Symbol itemId) const {
+    if (const sf::IntRect* rect = iconAtlas.getRect(itemId)) {
+        return rect;
+    }
+    
+    auto pending = pendingIcons.find(itemId);
+    if (pending != pendingIcons.end()) {
+        if (pending->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return nullptr;
+        }
+        std::optional<sf::Image> image = pending->second.get();
+        pendingIcons.erase(pending);
+        if (!image || !iconAtlas.upload(itemId, *image)) {
+            std::cerr << "Failed to load icon for item: " << symbolName(itemId) << std::endl;
+            missingIcons.insert(itemId);
+        }
+        return iconAtlas.getRect(itemId);
+    }
+    
+    const ItemDefinition* def = find(itemId);
+    if (!def || !iconAtlas.hasSlot(itemId) || missingIcons.count(itemId)) {
+        return nullptr;
+    }
+    
+    // Decoded straight to atlas size on the pool; the upload happens on a later call
+    pendingIcons[itemId] = ThreadPool::shared().submit(
+        [&resources = resources, path = def->texturePath]() -> std::optional<sf::Image> {
+            sf::Image image;
+            if (!resources.decodeImage(image, path, {IconAtlas::ICON_SIZE, IconAtlas::ICON_SIZE})) {
+                return std::nullopt;
+            }
+            return image;
+        });
+    return nullptr;
+}
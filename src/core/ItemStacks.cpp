@@ -0,0 +1,130 @@
+#include "ItemStacks.h"
+#include <algorithm>
+
+void ItemStacks::add(Symbol id, int quantity, int maxStackSize, bool stackable) {
+    if (quantity <= 0) {
+        return;
+    }
+    Entry& entry = index[id];
+    entry.total += quantity;
+    
+    // First, fill this item's stacks that still have room
+    if (stackable) {
+        for (std::size_t position : entry.positions) {
+            InventoryItem& stack = stacks[position];
+            if (stack.quantity < maxStackSize) {
+                int canAdd = std::min(quantity, maxStackSize - stack.quantity);
+                stack.quantity += canAdd;
+                quantity -= canAdd;
+                if (quantity <= 0) {
+                    return;
+                }
+            }
+        }
+    }
+    
+    // Create new stacks for remaining quantity
+    while (quantity > 0) {
+        int stackSize = stackable ? std::min(quantity, std::max(maxStackSize, 1)) : 1;
+        entry.positions.push_back(stacks.size());
+        stacks.emplace_back(id, stackSize);
+        quantity -= stackSize;
+    }
+}
+
+int ItemStacks::remove(Symbol id, int quantity) {
+    auto it = index.find(id);
+    if (it == index.end() || quantity <= 0) {
+        return 0;
+    }
+    
+    int removed = 0;
+    std::vector<std::size_t> emptied;
+    for (std::size_t position : it->second.positions) {
+        InventoryItem& stack = stacks[position];
+        int take = std::min(quantity - removed, stack.quantity);
+        stack.quantity -= take;
+        removed += take;
+        if (stack.quantity <= 0) {
+            emptied.push_back(position);
+        }
+        if (removed >= quantity) {
+            break;
+        }
+    }
+    it->second.total -= removed;
+    erase(emptied);
+    return removed;
+}
+
+Symbol ItemStacks::removeAt(std::size_t position, int quantity) {
+    if (position >= stacks.size()) {
+        return NO_SYMBOL;
+    }
+    
+    InventoryItem& stack = stacks[position];
+    Symbol id = stack.id;
+    int take = std::clamp(quantity, 0, stack.quantity);
+    stack.quantity -= take;
+    index[id].total -= take;
+    if (stack.quantity <= 0) {
+        erase({position});
+    }
+    return id;
+}
+
+void ItemStacks::append(Symbol id, int quantity) {
+    Entry& entry = index[id];
+    entry.total += quantity;
+    entry.positions.push_back(stacks.size());
+    stacks.emplace_back(id, quantity);
+}
+
+void ItemStacks::clear() {
+    stacks.clear();
+    index.clear();
+}
+
+int ItemStacks::count(Symbol id) const {
+    auto it = index.find(id);
+    return it != index.end() ? it->second.total : 0;
+}
+
+void ItemStacks::erase(const std::vector<std::size_t>& removed) {
+    if (removed.empty()) {
+        return;
+    }
+    std::vector<Symbol> removedIds;
+    for (std::size_t position : removed) {
+        removedIds.push_back(stacks[position].id);
+    }
+    
+    // Only stacks from the first removal on move; forget their positions first
+    std::size_t first = removed.front();
+    for (std::size_t position = first; position < stacks.size(); ++position) {
+        auto& positions = index[stacks[position].id].positions;
+        positions.erase(std::lower_bound(positions.begin(), positions.end(), first), positions.end());
+    }
+    
+    // Compact the tail in one pass, keeping slot order
+    std::size_t write = first;
+    auto next = removed.begin();
+    for (std::size_t read = first; read < stacks.size(); ++read) {
+        if (next != removed.end() && *next == read) {
+            ++next;
+            continue;
+        }
+        stacks[write] = stacks[read];
+        index[stacks[write].id].positions.push_back(write);
+        ++write;
+    }
+    stacks.erase(stacks.begin() + static_cast<std::ptrdiff_t>(write), stacks.end());
+    
+    // Items left without a stack drop out of the index
+    for (Symbol id : removedIds) {
+        auto it = index.find(id);
+        if (it != index.end() && it->second.positions.empty()) {
+            index.erase(it);
+        }
+    }
+}
@@ -2,15 +2,31 @@
 #include "CustomWindow.h"
 #include <iostream>
 
-PlayingState::PlayingState(ResourceManager& resources, const std::string& scriptPath)
+PlayingState::PlayingState(ResourceManager& resources, ItemRegistry& itemRegistry, const std::string& scriptPath,
+                           int saveSlot)
     : resources(resources),
       sceneManager(std::make_unique<SceneManager>(resources)),
       ui(std::make_unique<PlayingStateUI>(resources)),
-      gameState(std::make_unique<GameStateManager>()),
-      inventorySystem(std::make_unique<InventorySystem>(resources))
+      gameState(std::make_unique<GameStateManager>(saveSlot)),
+      inventorySystem(std::make_unique<InventorySystem>(itemRegistry))
 {
     ui->setInventorySystem(inventorySystem.get());
     
+    // Items keep the flags they declare in items.json in step with whether any are held
+    inventorySystem->setOnHeldChanged([this](const ItemDefinition& item, bool held) {
+        for (Symbol flag : item.flags) {
+            gameState->setFlag(flag, held || inventorySystem->holdsItemWithFlag(flag));
+        }
+    });
+    inventorySystem->setOnChanged([this](const InventoryChange& change) {
+        gameState->recordInventoryChange(change);
+    });
+    
+    // Only prefetch backgrounds behind choices the player can currently see
+    sceneManager->setChoiceFilter([this](const Condition& condition) {
+        return gameState->checkCondition(condition, inventorySystem.get());
+    });
+    
     // Initialize transition overlay to full opacity
     transitionOverlay.setFillColor(sf::Color(0, 0, 0, 255));
     transitionOverlay.setSize(sf::Vector2f(800.f, 600.f));
@@ -46,12 +62,19 @@ PlayingState::PlayingState(ResourceManager& resources, const std::string& script
     
     // Load the script
     if (sceneManager->loadScript(scriptToLoad)) {
+        const GameScript& script = sceneManager->getScript();
+        gameState->setScriptDetails(script.title, script.metadata.chapter);
+        
         // If we have a scene to load, use it; otherwise start from first scene
+        std::uint32_t sceneIndex = 0;
         if (!sceneToLoad.empty()) {
-            loadScene(sceneToLoad);
-        } else {
-            loadScene(sceneManager->getScript().scenes[0].id);
+            sceneIndex = ScriptParser::findSceneIndex(sceneManager->getScript(), sceneToLoad);
+            if (sceneIndex == SCENE_NONE) {
+                std::cerr << "Saved scene not found, restarting script: " << sceneToLoad << std::endl;
+                sceneIndex = 0;
+            }
         }
+        loadScene(sceneIndex);
     }
     
     // Start with fade-in transition
@@ -59,14 +82,18 @@ PlayingState::PlayingState(ResourceManager& resources, const std::string& script
     transitionAlpha = 255.f;
 }
 
+PlayingState::~PlayingState() {
+    gameState->compactSave(inventorySystem.get());
+}
+
 void PlayingState::setOnScriptComplete(std::function<void()> callback) {
     onScriptComplete = callback;
     sceneManager->setOnScriptComplete(callback);
 }
 
 // Load a scene, apply effects, save state, and create choice buttons
-void PlayingState::loadScene(const std::string& sceneId) {
-    if (!sceneManager->loadScene(sceneId)) {
+void PlayingState::loadScene(std::uint32_t sceneIndex) {
+    if (!sceneManager->loadScene(sceneIndex)) {
         return;
     }
     
@@ -75,12 +102,16 @@ void PlayingState::loadScene(const std::string& sceneId) {
     
     // Apply effects if present (modify stats, add items, etc.)
     if (currentScene->effects.has_value()) {
-        gameState->applyEffects(currentScene->effects.value(), inventorySystem.get());
+        EffectChanges changes = gameState->applyEffects(currentScene->effects.value(), inventorySystem.get());
+        
+        // Effects can change which choices are visible
+        if (!changes.empty()) {
+            sceneManager->prefetchFrom(sceneIndex);
+        }
     }
     
     // Save game state on EVERY scene transition
-    gameState->saveGame(sceneManager->getScript().scriptId, currentScene->id, 
-                      inventorySystem.get());
+    saveProgress();
     
     // Calculate layout metrics for text wrapping
     const float TITLEBAR_HEIGHT = CustomWindow::getTitlebarHeight();
@@ -93,26 +124,36 @@ void PlayingState::loadScene(const std::string& sceneId) {
     
     // Wrap text to fit dialog box
     float maxTextWidth = metrics.dialogBoxSize.x - (metrics.scale.boxPadding * 2);
-    std::string wrappedText = DialogBox::wrapText(currentScene->text, 
+    std::string wrappedText = DialogBox::wrapText(std::string(currentScene->text), 
                                                   static_cast<unsigned int>(maxTextWidth), 
                                                   resources.getFont("main"), 
                                                   dialogSize);
     
-    ui->getDialogBox().setText(wrappedText, currentScene->speaker, currentScene->speakerColor);
+    ui->getDialogBox().setText(wrappedText, std::string(currentScene->speaker), std::string(currentScene->speakerColor));
     
     createChoiceButtons();
     updatePositions(fullWindowSize);
 }
 
+void PlayingState::saveProgress() {
+    gameState->saveGame(sceneManager->getScript().scriptId, std::string(sceneManager->getCurrentScene()->id),
+                        inventorySystem.get());
+}
+
 // Initiate fade-out transition to next scene
-void PlayingState::startTransition(const std::string& sceneId) {
-    if (transitionState != TransitionState::None) {
+void PlayingState::startTransition(std::uint32_t sceneIndex) {
+    if (transitionState != TransitionState::None || sceneIndex == SCENE_NONE) {
         return;
     }
     
-    nextSceneId = sceneId;
+    nextSceneIndex = sceneIndex;
     transitionState = TransitionState::FadingOut;
     transitionAlpha = 0.f;
+    
+    // Decode the next background while the screen fades out
+    if (sceneIndex != SCENE_END) {
+        sceneManager->prepareScene(sceneIndex);
+    }
 }
 
 // Update fade transition and load next scene at midpoint
@@ -129,20 +170,23 @@ void PlayingState::updateTransition(float deltaTime) {
         if (transitionAlpha >= 255.f) {
             transitionAlpha = 255.f;
             
-            std::string sceneToLoad = nextSceneId;
-            nextSceneId.clear();
+            std::uint32_t sceneToLoad = nextSceneIndex;
             
             // Check if story is complete
-            if (sceneToLoad == "END") {
+            if (sceneToLoad == SCENE_END) {
+                nextSceneIndex = SCENE_NONE;
                 if (onScriptComplete) {
                     onScriptComplete();
                 }
                 return;
             }
             
-            // Load next scene at peak of fade
-            loadScene(sceneToLoad);
-            transitionState = TransitionState::FadingIn;
+            // Load next scene at peak of fade, holding on black (still rendering) until its background is decoded
+            if (sceneManager->isSceneReady(sceneToLoad)) {
+                nextSceneIndex = SCENE_NONE;
+                loadScene(sceneToLoad);
+                transitionState = TransitionState::FadingIn;
+            }
         }
     }
     else if (transitionState == TransitionState::FadingIn) {
@@ -174,27 +218,17 @@ void PlayingState::createChoiceButtons() {
         const auto& choice = currentScene->choices[i];
         
         // Skip choices that don't meet conditions
-        if (choice.condition.has_value() && !gameState->checkCondition(choice.condition.value())) {
+        if (choice.condition.has_value() && !gameState->checkCondition(choice.condition.value(), inventorySystem.get())) {
             continue;
         }
         
         auto button = std::make_unique<Button>(resources, nullptr, sf::Vector2f(0, 0));
-        button->setText(std::string(1, labels[labelIndex]) + ") " + choice.text, 
+        button->setText(std::string(1, labels[labelIndex]) + ") " + std::string(choice.text), 
                        resources.getFont("main"), 22);
         
-        std::string nextScene = choice.nextScene;
-        std::string nextScript = choice.nextScript;
-        
         // Handle script changes or scene transitions
-        button->setOnClick([this, nextScene, nextScript]() {
-            if (!nextScript.empty()) {
-                sceneManager->loadScript(nextScript);
-                if (!sceneManager->getScript().scenes.empty()) {
-                    startTransition(sceneManager->getScript().scenes[0].id);
-                }
-            } else {
-                startTransition(nextScene);
-            }
+        button->setOnClick([this, choice]() {
+            takeChoice(choice);
         });
         
         choiceButtons.push_back(std::move(button));
@@ -202,6 +236,23 @@ void PlayingState::createChoiceButtons() {
     }
 }
 
+// Follow a choice: chained scripts start at their first scene, otherwise jump to the resolved target
+void PlayingState::takeChoice(const Choice& choice) {
+    if (!choice.nextScript.empty()) {
+        sceneManager->loadScript(std::string(choice.nextScript));
+        if (sceneManager->getScript().sceneCount() > 0) {
+            startTransition(0);
+        }
+        return;
+    }
+    
+    if (choice.target == SCENE_NONE) {
+        std::cerr << "Choice has no valid target: " << choice.nextScene << std::endl;
+        return;
+    }
+    startTransition(choice.target);
+}
+
 void PlayingState::updatePositions(const sf::Vector2u& newWindowSize) {
     currentWindowSize = newWindowSize;  // Store for later use
     const float TITLEBAR_HEIGHT = CustomWindow::getTitlebarHeight();
@@ -213,6 +264,9 @@ void PlayingState::updatePositions(const sf::Vector2u& newWindowSize) {
     const Scene* currentScene = sceneManager->getCurrentScene();
     ui->updatePositions(newWindowSize, currentScene);
     ui->updateChoiceButtons(choiceButtons, currentScene);
+    
+    // Backgrounds are kept at the size they are drawn at, not the size of the asset
+    sceneManager->setDisplaySize(sf::Vector2u(ui->getGraphicsBoxSize()));
 }
 
 // Show Y/N confirmation dialog for item deletion
@@ -264,16 +318,12 @@ void PlayingState::handleConfirmation(bool confirmed) {
     
     // Remove item(s) and save game state
     if (confirmationType == ConfirmationType::ThrowOut) {
-        inventorySystem->removeItemAtIndex(pendingActionItemIndex, 1, gameState.get());
-        gameState->saveGame(sceneManager->getScript().scriptId, 
-                          sceneManager->getCurrentScene()->id,
-                          inventorySystem.get());
+        inventorySystem->removeItemAtIndex(pendingActionItemIndex, 1);
+        saveProgress();
     }
     else if (confirmationType == ConfirmationType::ThrowOutAll) {
-        inventorySystem->removeItemAtIndex(pendingActionItemIndex, items[pendingActionItemIndex].quantity, gameState.get());
-        gameState->saveGame(sceneManager->getScript().scriptId, 
-                          sceneManager->getCurrentScene()->id,
-                          inventorySystem.get());
+        inventorySystem->removeItemAtIndex(pendingActionItemIndex, items[pendingActionItemIndex].quantity);
+        saveProgress();
     }
     
     confirmationType = ConfirmationType::None;
@@ -328,21 +378,15 @@ void PlayingState::handleEvent(const sf::Event& event) {
         const Scene* currentScene = sceneManager->getCurrentScene();
         if (currentScene && choiceIndex >= 0 && 
             choiceIndex < static_cast<int>(currentScene->choices.size())) {
-            const auto& choice = currentScene->choices[choiceIndex];
-            if (!choice.nextScript.empty()) {
-                sceneManager->loadScript(choice.nextScript);
-                if (!sceneManager->getScript().scenes.empty()) {
-                    startTransition(sceneManager->getScript().scenes[0].id);
-                }
-            } else {
-                startTransition(choice.nextScene);
-            }
+            takeChoice(currentScene->choices[choiceIndex]);
         }
     }
 }
 
 void PlayingState::update(float deltaTime, sf::RenderWindow& window) {
+    gameState->addPlaytime(deltaTime);
     updateTransition(deltaTime);
+    sceneManager->update();
     
     // Only update interactive elements when not transitioning or confirming
     if (transitionState == TransitionState::None && confirmationType == ConfirmationType::None) {
@@ -2,45 +2,296 @@
 
 #include "ResourceManager.h"
 #include <iostream>
+#include <vector>
+
+bool ResourceManager::mountPack(const std::string& path)
+{
+    if (!pack.open(path))
+    {
+        std::cerr << "Asset pack not available, loading loose files: " << path << std::endl;
+        return false;
+    }
+    std::cout << "Mounted asset pack " << path << " (" << pack.size() << " assets)" << std::endl;
+    return true;
+}
+
+bool ResourceManager::loadManifest()
+{
+    if (auto blob = pack.find(AssetManifest::DEFAULT_PATH))
+    {
+        if (manifest.loadFromMemory(blob->data, blob->size))
+        {
+            return true;
+        }
+    }
+    else if (manifest.loadFromFile(AssetManifest::DEFAULT_PATH))
+    {
+        return true;
+    }
+    
+    // No generated manifest (e.g. running from the source tree): index the files once now
+    std::cerr << "Asset manifest not found, scanning assets" << std::endl;
+    return manifest.scan("assets", "assets/", {"scripts", "save_data.json", "save_data.uasv", "save_data.uasj", "saves", "manifest.json"});
+}
+
+std::size_t ResourceManager::expectedTextureBytes(const std::string& path) const
+{
+    const AssetInfo* info = manifest.findByPath(path);
+    return info ? info->decodedBytes() : 0;
+}
+
+void ResourceManager::enableDecodedCache(const std::string& directory)
+{
+    decodedCache = std::make_unique<const DecodedImageCache>(directory);
+}
+
+DecodedImageCache::Source ResourceManager::describeSource(const std::string& path) const
+{
+    if (auto blob = pack.find(path))
+    {
+        DecodedImageCache::Source source;
+        source.path = path;
+        source.data = blob->data;
+        source.size = blob->size;
+        source.stamp = pack.entryStamp(*blob);
+        return source;
+    }
+    return DecodedImageCache::describeFile(path);
+}
+
+bool ResourceManager::decodeImage(sf::Image& image, const std::string& path, sf::Vector2u maxSize) const
+{
+    if (!decodedCache && maxSize == sf::Vector2u())
+    {
+        auto blob = pack.find(path);
+        return blob ? image.loadFromMemory(blob->data, blob->size) : image.loadFromFile(path);
+    }
+    
+    DecodedImageCache::Source source = describeSource(path);
+    if (decodedCache)
+    {
+        if (auto entry = decodedCache->load(source, {maxSize.x, maxSize.y}))
+        {
+            image = sf::Image({entry->width(), entry->height()}, entry->pixels());
+            return true;
+        }
+    }
+    return decodeAndCache(image, source, maxSize);
+}
+
+bool ResourceManager::decodeAndCache(sf::Image& image, const DecodedImageCache::Source& source, sf::Vector2u maxSize) const
+{
+    bool decoded = source.data ? image.loadFromMemory(source.data, source.size) : image.loadFromFile(source.path);
+    if (!decoded)
+    {
+        return false;
+    }
+    
+    ImageScaling::Size size{image.getSize().x, image.getSize().y};
+    ImageScaling::Size target = ImageScaling::fitWithin(size, {maxSize.x, maxSize.y});
+    if (target.width != size.width || target.height != size.height)
+    {
+        std::vector<std::uint8_t> pixels = ImageScaling::downscaleBox(image.getPixelsPtr(), size, target);
+        image = sf::Image({target.width, target.height}, pixels.data());
+    }
+    
+    if (decodedCache)
+    {
+        decodedCache->store(source, {maxSize.x, maxSize.y}, image.getPixelsPtr(), {image.getSize().x, image.getSize().y});
+    }
+    return true;
+}
+
+bool ResourceManager::readTexture(sf::Texture& texture, const std::string& path) const
+{
+    if (!decodedCache)
+    {
+        auto blob = pack.find(path);
+        return blob ? texture.loadFromMemory(blob->data, blob->size) : texture.loadFromFile(path);
+    }
+    
+    // Warm: upload straight from the mapped cache file, no decode and no intermediate image
+    DecodedImageCache::Source source = describeSource(path);
+    if (auto entry = decodedCache->load(source))
+    {
+        if (texture.resize({entry->width(), entry->height()}))
+        {
+            texture.update(entry->pixels());
+            return true;
+        }
+        return false;
+    }
+    
+    sf::Image image;
+    return decodeAndCache(image, source, {}) && texture.loadFromImage(image);
+}
+
+// Fonts and music keep reading from their source, which the mapping outlives
+bool ResourceManager::decodeFont(sf::Font& font, const std::string& path) const
+{
+    if (auto blob = pack.find(path))
+    {
+        return font.openFromMemory(blob->data, blob->size);
+    }
+    return font.openFromFile(path);
+}
+
+bool ResourceManager::decodeSoundBuffer(sf::SoundBuffer& buffer, const std::string& path) const
+{
+    if (auto blob = pack.find(path))
+    {
+        return buffer.loadFromMemory(blob->data, blob->size);
+    }
+    return buffer.loadFromFile(path);
+}
 
 // Load a texture from file and store it with an ID
 bool ResourceManager::loadTexture(const std::string& id, const std::string& path)
 {
+    return loadTexture(intern(id), path);
+}
+
+bool ResourceManager::loadTexture(Symbol id, const std::string& path)
+{
+    // Make room before the upload so the cache never holds more than the budget
+    evictTextures(expectedTextureBytes(path));
+    
     sf::Texture texture;
-    if (!texture.loadFromFile(path))
+    if (!readTexture(texture, path))
     {
         std::cerr << "Failed to load texture: " << path << std::endl;
         return false;
     }
     texture.setSmooth(true);
-    textures[id] = std::move(texture);
+    storeTexture(id, std::move(texture));
     return true;
 }
 
+// Upload an already decoded image as a texture
+bool ResourceManager::addTexture(Symbol id, const sf::Image& image)
+{
+    return uploadTexture(id, image) != nullptr;
+}
+
+TextureHandle ResourceManager::uploadTexture(Symbol id, const sf::Image& image)
+{
+    evictTextures(static_cast<std::size_t>(image.getSize().x) * image.getSize().y * 4);
+    
+    sf::Texture texture;
+    if (!texture.loadFromImage(image))
+    {
+        std::cerr << "Failed to create texture: " << symbolName(id) << std::endl;
+        return nullptr;
+    }
+    texture.setSmooth(true);
+    return storeTexture(id, std::move(texture));
+}
+
+TextureHandle ResourceManager::storeTexture(Symbol id, sf::Texture&& texture)
+{
+    sf::Vector2u size = texture.getSize();
+    std::size_t bytes = static_cast<std::size_t>(size.x) * size.y * 4;
+    
+    auto it = textures.find(id);
+    if (it != textures.end())
+    {
+        TextureEntry& entry = it->second;
+        *entry.texture = std::move(texture);
+        textureBytes = textureBytes - entry.bytes + bytes;
+        entry.bytes = bytes;
+        touch(entry);
+    }
+    else
+    {
+        TextureEntry entry;
+        entry.texture = std::make_shared<sf::Texture>(std::move(texture));
+        entry.bytes = bytes;
+        textureLru.push_front(id);
+        entry.lruPosition = textureLru.begin();
+        it = textures.emplace(id, std::move(entry)).first;
+        textureBytes += bytes;
+    }
+    
+    // Hold a handle while evicting so the new texture itself stays
+    TextureHandle handle = it->second.texture;
+    evictTextures();
+    return handle;
+}
+
+void ResourceManager::touch(TextureEntry& entry)
+{
+    textureLru.splice(textureLru.begin(), textureLru, entry.lruPosition);
+}
+
+void ResourceManager::evictTextures(std::size_t incomingBytes)
+{
+    // Walk from the least recently used end, skipping pinned textures
+    auto it = textureLru.end();
+    while (textureBytes + incomingBytes > textureBudget && it != textureLru.begin())
+    {
+        --it;
+        auto entryIt = textures.find(*it);
+        const TextureEntry& entry = entryIt->second;
+        if (entry.pinned || entry.texture.use_count() > 1)
+        {
+            continue;
+        }
+        
+        textureBytes -= entry.bytes;
+        textures.erase(entryIt);
+        it = textureLru.erase(it);
+        ++textureEvictions;
+    }
+}
+
+void ResourceManager::setTextureBudget(std::size_t bytes)
+{
+    textureBudget = bytes;
+    evictTextures();
+}
+
+TextureCacheStats ResourceManager::getTextureStats() const
+{
+    TextureCacheStats stats;
+    stats.hits = textureHits;
+    stats.misses = textureMisses;
+    stats.evictions = textureEvictions;
+    stats.textureCount = textures.size();
+    stats.residentBytes = textureBytes;
+    stats.budgetBytes = textureBudget;
+    return stats;
+}
+
 // Load a font from file and store it with an ID
 bool ResourceManager::loadFont(const std::string& id, const std::string& path)
 {
     sf::Font font;
-    if (!font.openFromFile(path))
+    if (!decodeFont(font, path))
     {
         std::cerr << "Failed to load font: " << path << std::endl;
         return false;
     }
-    fonts[id] = std::move(font);
+    fonts[intern(id)] = std::move(font);
     return true;
 }
 
+void ResourceManager::addFont(Symbol id, sf::Font&& font)
+{
+    fonts[id] = std::move(font);
+}
+
 // Load music from file and store it with an ID
 bool ResourceManager::loadMusic(const std::string& id, const std::string& path)
 {
     auto musicPtr = std::make_unique<sf::Music>();
-    if (!musicPtr->openFromFile(path))
+    auto blob = pack.find(path);
+    if (blob ? !musicPtr->openFromMemory(blob->data, blob->size) : !musicPtr->openFromFile(path))
     {
         std::cerr << "Failed to load music: " << path << std::endl;
         std::cerr << "Current working directory: " << std::filesystem::current_path() << std::endl;
         return false;
     }
-    music[id] = std::move(musicPtr);
+    music[intern(id)] = std::move(musicPtr);
     std::cout << "Successfully loaded music: " << id << std::endl;
     return true;
 }
@@ -49,23 +300,61 @@ bool ResourceManager::loadMusic(const std::string& id, const std::string& path)
 bool ResourceManager::loadSoundBuffer(const std::string& id, const std::string& path)
 {
     sf::SoundBuffer buffer;
-    if (!buffer.loadFromFile(path))
+    if (!decodeSoundBuffer(buffer, path))
     {
         std::cerr << "Failed to load sound buffer: " << path << std::endl;
         return false;
     }
-    soundBuffers[id] = std::move(buffer);
+    soundBuffers[intern(id)] = std::move(buffer);
     return true;
 }
 
+void ResourceManager::addSoundBuffer(Symbol id, sf::SoundBuffer&& buffer)
+{
+    soundBuffers[id] = std::move(buffer);
+}
+
 // Get a previously loaded texture by ID
 sf::Texture& ResourceManager::getTexture(const std::string& id)
 {
-    return textures.at(id);
+    return getTexture(SymbolTable::global().find(id));
+}
+
+sf::Texture& ResourceManager::getTexture(Symbol id)
+{
+    // The caller may keep the reference indefinitely, so it can never be evicted
+    TextureEntry& entry = textures.at(id);
+    entry.pinned = true;
+    touch(entry);
+    return *entry.texture;
+}
+
+TextureHandle ResourceManager::acquireTexture(Symbol id)
+{
+    auto it = textures.find(id);
+    if (it == textures.end())
+    {
+        ++textureMisses;
+        return nullptr;
+    }
+    ++textureHits;
+    touch(it->second);
+    return it->second.texture;
+}
+
+sf::Vector2u ResourceManager::getTextureSize(Symbol id) const
+{
+    auto it = textures.find(id);
+    return it != textures.end() ? it->second.texture->getSize() : sf::Vector2u();
 }
 
 // Get a previously loaded font by ID
 sf::Font& ResourceManager::getFont(const std::string& id)
+{
+    return fonts.at(SymbolTable::global().find(id));
+}
+
+sf::Font& ResourceManager::getFont(Symbol id)
 {
     return fonts.at(id);
 }
@@ -73,11 +362,11 @@ sf::Font& ResourceManager::getFont(const std::string& id)
 // Get a previously loaded music track by ID
 sf::Music& ResourceManager::getMusic(const std::string& id)
 {
-    return *music.at(id);
+    return *music.at(SymbolTable::global().find(id));
 }
 
 // Get a previously loaded sound buffer by ID
 sf::SoundBuffer& ResourceManager::getSoundBuffer(const std::string& id)
 {
-    return soundBuffers.at(id);
+    return soundBuffers.at(SymbolTable::global().find(id));
 }
\ No newline at end of file
@@ -0,0 +1,343 @@
+#include "SaveFormat.h"
+#include <cstring>
+#include <string_view>
+
+namespace SaveFormat {
+
+namespace {
+
+std::uint32_t checksum(const std::uint8_t* data, std::size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Minimal CBOR writer for the handful of types a save uses (RFC 8949)
+class CborWriter {
+public:
+    explicit CborWriter(std::vector<std::uint8_t>& out) : out(out) {}
+    
+    void map(std::size_t size) { head(5, size); }
+    void array(std::size_t size) { head(4, size); }
+    void boolean(bool value) { out.push_back(value ? 0xF5 : 0xF4); }
+    
+    void text(std::string_view value) {
+        head(3, value.size());
+        out.insert(out.end(), value.begin(), value.end());
+    }
+    
+    void integer(std::int64_t value) {
+        if (value >= 0) {
+            head(0, static_cast<std::uint64_t>(value));
+        } else {
+            head(1, static_cast<std::uint64_t>(-(value + 1)));
+        }
+    }
+    
+private:
+    // Major type plus the shortest argument encoding, as nlohmann::json::to_cbor chooses
+    void head(std::uint8_t major, std::uint64_t value) {
+        std::uint8_t type = static_cast<std::uint8_t>(major << 5);
+        if (value < 24) {
+            out.push_back(type | static_cast<std::uint8_t>(value));
+            return;
+        }
+        int bytes = value <= 0xFF ? 1 : value <= 0xFFFF ? 2 : value <= 0xFFFFFFFFull ? 4 : 8;
+        out.push_back(type | static_cast<std::uint8_t>(bytes == 1 ? 24 : bytes == 2 ? 25 : bytes == 4 ? 26 : 27));
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<std::uint8_t>(value >> shift));
+        }
+    }
+    
+    std::vector<std::uint8_t>& out;
+};
+
+// Fill in the header in front of an encoded payload
+void finish(std::vector<std::uint8_t>& bytes, const char (&magic)[4] = kMagic, std::uint32_t version = kVersion) {
+    SaveHeader header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.payloadSize = static_cast<std::uint32_t>(bytes.size() - sizeof(SaveHeader));
+    header.checksum = checksum(bytes.data() + sizeof(SaveHeader), header.payloadSize);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+}
+
+// Journal record fields, in host byte order like the headers
+void putU16(std::vector<std::uint8_t>& out, std::uint16_t value) {
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+void putU32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+void putString(std::vector<std::uint8_t>& out, std::string_view value) {
+    value = value.substr(0, 0xFFFF);
+    putU16(out, static_cast<std::uint16_t>(value.size()));
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+// Bounds-checked reads from one record's payload
+class RecordReader {
+public:
+    RecordReader(const std::uint8_t* data, std::size_t size) : data(data), size(size) {}
+    
+    bool u8(std::uint8_t& value) { return read(&value, 1); }
+    bool u16(std::uint16_t& value) { return read(&value, sizeof(value)); }
+    
+    bool i32(std::int32_t& value) { return read(&value, sizeof(value)); }
+    
+    bool text(std::string& value) {
+        std::uint16_t length;
+        if (!u16(length) || size - position < length) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(data + position), length);
+        position += length;
+        return true;
+    }
+    
+    bool symbol(Symbol& value) {
+        std::string name;
+        if (!text(name)) {
+            return false;
+        }
+        value = intern(name);
+        return true;
+    }
+    
+    bool atEnd() const { return position == size; }
+    
+private:
+    bool read(void* value, std::size_t count) {
+        if (size - position < count) {
+            return false;
+        }
+        std::memcpy(value, data + position, count);
+        position += count;
+        return true;
+    }
+    
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t position = 0;
+};
+
+bool readPayload(RecordReader& in, JournalRecord& record) {
+    using Type = JournalRecord::Type;
+    switch (record.type) {
+        case Type::SetFlag: {
+            std::uint8_t value;
+            if (!in.symbol(record.key) || !in.u8(value)) return false;
+            record.value = value;
+            return true;
+        }
+        case Type::AddStat:
+        case Type::AddItem:
+        case Type::RemoveItem:
+            return in.symbol(record.key) && in.i32(record.value);
+        case Type::RemoveItemAt:
+            return in.i32(record.index) && in.i32(record.value);
+        case Type::Location:
+            return in.text(record.script) && in.text(record.scene);
+    }
+    return false;
+}
+
+// Validate a SaveHeader-framed file with this magic and version
+bool check(const std::uint8_t* data, std::size_t size, const char (&magic)[4], std::uint32_t version,
+           const std::string& what, Payload& payload, std::string& error) {
+    if (size < sizeof(SaveHeader) || std::memcmp(data, magic, sizeof(magic)) != 0) {
+        error = "not a binary " + what;
+        return false;
+    }
+    SaveHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != version) {
+        error = "unsupported " + what + " version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.payloadSize != size - sizeof(SaveHeader)) {
+        error = what + " size does not match its header";
+        return false;
+    }
+    if (checksum(data + sizeof(SaveHeader), header.payloadSize) != header.checksum) {
+        error = what + " checksum mismatch";
+        return false;
+    }
+    payload = {data + sizeof(SaveHeader), header.payloadSize, header.checksum};
+    return true;
+}
+
+constexpr std::size_t kRecordHead = 3;   // type, size
+constexpr std::size_t kRecordTail = 4;   // checksum
+
+} // namespace
+
+std::vector<std::uint8_t> encode(const SaveState& state) {
+    std::vector<std::uint8_t> bytes(sizeof(SaveHeader));
+    bytes.reserve(256 + state.flags.size() * 24 + state.stats.size() * 24 + state.inventory.size() * 40);
+    CborWriter cbor(bytes);
+    
+    // Same keys as SaveWriter::toJson
+    cbor.map(6);
+    cbor.text("currentScene");
+    cbor.text(state.currentScene);
+    cbor.text("currentScript");
+    cbor.text(state.currentScript);
+    cbor.text("flags");
+    cbor.map(state.flags.size());
+    for (const auto& [flag, value] : state.flags) {
+        cbor.text(symbolName(flag));
+        cbor.boolean(value);
+    }
+    cbor.text("inventory");
+    cbor.array(state.inventory.size());
+    for (const auto& item : state.inventory) {
+        cbor.map(2);
+        cbor.text("id");
+        cbor.text(symbolName(item.id));
+        cbor.text("quantity");
+        cbor.integer(item.quantity);
+    }
+    cbor.text("playerName");
+    cbor.text("");
+    cbor.text("stats");
+    cbor.map(state.stats.size());
+    for (const auto& [stat, value] : state.stats) {
+        cbor.text(symbolName(stat));
+        cbor.integer(value);
+    }
+    
+    finish(bytes);
+    return bytes;
+}
+
+std::vector<std::uint8_t> encode(const nlohmann::json& save) {
+    std::vector<std::uint8_t> bytes(sizeof(SaveHeader));
+    nlohmann::json::to_cbor(save, bytes);
+    finish(bytes);
+    return bytes;
+}
+
+bool isBinary(const std::uint8_t* data, std::size_t size) {
+    return size >= sizeof(kMagic) && std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool decode(const std::uint8_t* data, std::size_t size, Payload& payload, std::string& error) {
+    return check(data, size, kMagic, kVersion, "save", payload, error);
+}
+
+std::vector<std::uint8_t> encodeIndex(const nlohmann::json& index) {
+    std::vector<std::uint8_t> bytes(sizeof(SaveHeader));
+    nlohmann::json::to_cbor(index, bytes);
+    finish(bytes, kIndexMagic, kIndexVersion);
+    return bytes;
+}
+
+bool decodeIndex(const std::uint8_t* data, std::size_t size, Payload& payload, std::string& error) {
+    return check(data, size, kIndexMagic, kIndexVersion, "save index", payload, error);
+}
+
+std::uint32_t snapshotChecksum(const std::vector<std::uint8_t>& encoded) {
+    SaveHeader header;
+    std::memcpy(&header, encoded.data(), sizeof(header));
+    return header.checksum;
+}
+
+std::vector<std::uint8_t> journalHeader(std::uint32_t baseChecksum) {
+    JournalHeader header;
+    std::memcpy(header.magic, kJournalMagic, sizeof(kJournalMagic));
+    header.version = kJournalVersion;
+    header.baseChecksum = baseChecksum;
+    std::vector<std::uint8_t> bytes(sizeof(header));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    return bytes;
+}
+
+void appendRecord(std::vector<std::uint8_t>& out, const JournalRecord& record) {
+    using Type = JournalRecord::Type;
+    const std::size_t start = out.size();
+    out.push_back(static_cast<std::uint8_t>(record.type));
+    putU16(out, 0);
+    switch (record.type) {
+        case Type::SetFlag:
+            putString(out, symbolName(record.key));
+            out.push_back(record.value != 0 ? 1 : 0);
+            break;
+        case Type::AddStat:
+        case Type::AddItem:
+        case Type::RemoveItem:
+            putString(out, symbolName(record.key));
+            putU32(out, static_cast<std::uint32_t>(record.value));
+            break;
+        case Type::RemoveItemAt:
+            putU32(out, static_cast<std::uint32_t>(record.index));
+            putU32(out, static_cast<std::uint32_t>(record.value));
+            break;
+        case Type::Location:
+            putString(out, record.script);
+            putString(out, record.scene);
+            break;
+    }
+    
+    // Payloads are a few names at most, far below the u16 size limit
+    std::uint16_t payloadSize = static_cast<std::uint16_t>(out.size() - start - kRecordHead);
+    std::memcpy(out.data() + start + 1, &payloadSize, sizeof(payloadSize));
+    putU32(out, checksum(out.data() + start, out.size() - start));
+}
+
+bool readJournal(const std::uint8_t* data, std::size_t size, std::uint32_t baseChecksum,
+                 std::vector<JournalRecord>& records, std::string& error) {
+    JournalHeader header;
+    if (size < sizeof(header) || std::memcmp(data, kJournalMagic, sizeof(kJournalMagic)) != 0) {
+        error = "not a save journal";
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != kJournalVersion) {
+        error = "unsupported journal version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.baseChecksum != baseChecksum) {
+        error = "journal extends an older save";
+        return false;
+    }
+    
+    std::size_t position = sizeof(header);
+    while (size - position >= kRecordHead + kRecordTail) {
+        const std::uint8_t* head = data + position;
+        std::uint16_t payloadSize;
+        std::memcpy(&payloadSize, head + 1, sizeof(payloadSize));
+        const std::size_t framed = kRecordHead + payloadSize;
+        if (size - position < framed + kRecordTail) {
+            break;
+        }
+        std::uint32_t stored;
+        std::memcpy(&stored, head + framed, sizeof(stored));
+        if (checksum(head, framed) != stored) {
+            break;
+        }
+        
+        JournalRecord record;
+        record.type = static_cast<JournalRecord::Type>(head[0]);
+        RecordReader in(head + kRecordHead, payloadSize);
+        if (!readPayload(in, record) || !in.atEnd()) {
+            break;
+        }
+        records.push_back(std::move(record));
+        position += framed + kRecordTail;
+    }
+    
+    if (position < size) {
+        error = "dropped " + std::to_string(size - position) + " bytes after the last complete journal record";
+    }
+    return true;
+}
+
+} // namespace SaveFormat
@@ -0,0 +1,154 @@
+#include "SaveSlots.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+SaveSlots::SaveSlots(std::string directory)
+    : directory(std::move(directory)),
+      slots(SLOT_COUNT)
+{
+    // Construct the pool first so it is destroyed after the slots and still runs the
+    // writes the destructor flushes
+    ThreadPool::shared();
+
+    std::error_code ec;
+    fs::create_directories(this->directory, ec);
+    indexPath = this->directory + "/index.uasi";
+    for (int slot = 0; slot < SLOT_COUNT; ++slot) {
+        const std::string base = this->directory + "/slot" + std::to_string(slot + 1);
+        writers.push_back(std::make_unique<SaveWriter>(base + SaveFormat::kExtension, base + ".uasj"));
+    }
+    loadIndex();
+}
+
+SaveSlots::~SaveSlots() {
+    flush();
+}
+
+SaveSlots& SaveSlots::global() {
+    static SaveSlots saveSlots;
+    return saveSlots;
+}
+
+SlotInfo SaveSlots::getSlot(int slot) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (slot < 0 || slot >= SLOT_COUNT) {
+        return SlotInfo{};
+    }
+    return slots[slot];
+}
+
+void SaveSlots::update(int slot, SlotInfo info) {
+    if (slot < 0 || slot >= SLOT_COUNT) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    slots[slot] = std::move(info);
+    indexDirty = true;
+    if (!draining) {
+        draining = true;
+        drain = ThreadPool::shared().submit([this]() { drainIndex(); }).share();
+    }
+}
+
+void SaveSlots::setJournaling(bool enabled) {
+    for (auto& writer : writers) {
+        writer->setJournaling(enabled);
+    }
+}
+
+void SaveSlots::flush() {
+    for (auto& writer : writers) {
+        writer->flush();
+    }
+    std::shared_future<void> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = drain;
+    }
+    if (job.valid()) {
+        job.wait();
+    }
+}
+
+void SaveSlots::loadIndex() {
+    using json = nlohmann::json;
+
+    std::error_code ec;
+    if (!fs::exists(indexPath, ec)) {
+        // A save from before slots shows up in the first slot until it is next saved
+        if (fs::exists(SaveFormat::kLegacyBinaryPath, ec) || fs::exists(SaveFormat::kLegacyJsonPath, ec)) {
+            slots[0].used = true;
+        }
+        return;
+    }
+
+    MappedFile file;
+    SaveFormat::Payload payload;
+    std::string error;
+    if (!file.open(indexPath) || !SaveFormat::decodeIndex(file.data(), file.size(), payload, error)) {
+        std::cerr << "Failed to read save index: " << (error.empty() ? indexPath : error) << std::endl;
+        return;
+    }
+
+    try {
+        json index = json::from_cbor(payload.data, payload.data + payload.size);
+        for (std::size_t slot = 0; slot < index.size() && slot < slots.size(); ++slot) {
+            const json& entry = index[slot];
+            SlotInfo& info = slots[slot];
+            info.used = entry.value("used", false);
+            info.scriptId = entry.value("scriptId", "");
+            info.scriptTitle = entry.value("title", "");
+            info.chapter = entry.value("chapter", 0);
+            info.sceneId = entry.value("scene", "");
+            info.playtimeSeconds = entry.value("playtime", 0u);
+            info.savedAt = entry.value("savedAt", std::int64_t{0});
+            info.thumbnailOffset = entry.value("thumbnailOffset", 0u);
+            info.thumbnailSize = entry.value("thumbnailSize", 0u);
+        }
+    } catch (const json::exception& e) {
+        std::cerr << "Failed to read save index: " << e.what() << std::endl;
+        slots.assign(SLOT_COUNT, SlotInfo{});
+    }
+}
+
+// Write until no further update has come in; a burst of saves costs one index write
+void SaveSlots::drainIndex() {
+    while (true) {
+        std::vector<SlotInfo> entries;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!indexDirty) {
+                draining = false;
+                return;
+            }
+            entries = slots;
+            indexDirty = false;
+        }
+        writeIndex(entries);
+    }
+}
+
+bool SaveSlots::writeIndex(const std::vector<SlotInfo>& entries) const {
+    using json = nlohmann::json;
+
+    json index = json::array();
+    for (const SlotInfo& info : entries) {
+        index.push_back({
+            {"used", info.used},
+            {"scriptId", info.scriptId},
+            {"title", info.scriptTitle},
+            {"chapter", info.chapter},
+            {"scene", info.sceneId},
+            {"playtime", info.playtimeSeconds},
+            {"savedAt", info.savedAt},
+            {"thumbnailOffset", info.thumbnailOffset},
+            {"thumbnailSize", info.thumbnailSize}
+        });
+    }
+
+    return SaveWriter::writeFileReplacing(indexPath, SaveFormat::encodeIndex(index), "write save index");
+}
@@ -0,0 +1,169 @@
+#include "SaveWriter.h"
+#include "SaveFormat.h"
+#include "ThreadPool.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+SaveWriter::SaveWriter(std::string path, std::string journalPath)
+    : path(std::move(path)), journalPath(std::move(journalPath)) {
+    // Construct the pool first so it is destroyed after the writer and still runs the
+    // drain the destructor flushes
+    ThreadPool::shared();
+}
+
+SaveWriter::~SaveWriter() {
+    flush();
+}
+
+void SaveWriter::submit(SaveState state) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending = std::move(state);
+    pendingRecords.clear();
+    if (!draining) {
+        draining = true;
+        drain = ThreadPool::shared().submit([this]() { drainPending(); }).share();
+    }
+}
+
+void SaveWriter::append(std::vector<std::uint8_t> records) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingRecords.insert(pendingRecords.end(), records.begin(), records.end());
+    if (!draining) {
+        draining = true;
+        drain = ThreadPool::shared().submit([this]() { drainPending(); }).share();
+    }
+}
+
+void SaveWriter::flush() {
+    std::shared_future<void> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = drain;
+    }
+    if (job.valid()) {
+        job.wait();
+    }
+}
+
+// Write until nothing new has been submitted; later states overwrite pending, never queue up
+void SaveWriter::drainPending() {
+    while (true) {
+        std::optional<SaveState> state;
+        std::vector<std::uint8_t> records;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!pending && pendingRecords.empty()) {
+                draining = false;
+                return;
+            }
+            state = std::move(pending);
+            pending.reset();
+            records.swap(pendingRecords);
+        }
+        
+        if (state) {
+            std::uint32_t checksum = 0;
+            if (!write(*state, checksum)) {
+                journalReady = false;
+                continue;
+            }
+            std::cout << "Game saved: " << state->currentScript << " - " << state->currentScene << std::endl;
+            
+            // A journal left from the previous snapshot no longer matches; replace or drop it
+            if (journaling) {
+                journalReady = startJournal(checksum, records);
+            } else {
+                std::error_code ec;
+                fs::remove(journalPath, ec);
+                journalReady = false;
+            }
+        } else if (!journalReady) {
+            std::cerr << "Failed to save game: no snapshot for the journal to extend" << std::endl;
+        } else if (!appendJournal(records)) {
+            journalReady = false;
+        }
+    }
+}
+
+bool SaveWriter::writeFileReplacing(const std::string& path, const std::vector<std::uint8_t>& bytes,
+                                    const char* what) {
+    const std::string tempPath = path + ".tmp";
+    std::error_code ec;
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to " << what << ": cannot write " << tempPath << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file.flush()) {
+            std::cerr << "Failed to " << what << ": write error on " << tempPath << std::endl;
+            file.close();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+    }
+    
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        std::cerr << "Failed to " << what << ": " << ec.message() << std::endl;
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool SaveWriter::write(const SaveState& state, std::uint32_t& checksum) const {
+    std::vector<std::uint8_t> bytes = SaveFormat::encode(state);
+    checksum = SaveFormat::snapshotChecksum(bytes);
+    return writeFileReplacing(path, bytes, "save game");
+}
+
+// Replaced whole, like the save, so the journal on disk always has a valid header
+bool SaveWriter::startJournal(std::uint32_t baseChecksum, const std::vector<std::uint8_t>& records) const {
+    std::vector<std::uint8_t> bytes = SaveFormat::journalHeader(baseChecksum);
+    bytes.insert(bytes.end(), records.begin(), records.end());
+    return writeFileReplacing(journalPath, bytes, "start save journal");
+}
+
+// A crash mid-append leaves a torn last record, which loading drops
+bool SaveWriter::appendJournal(const std::vector<std::uint8_t>& records) const {
+    std::ofstream file(journalPath, std::ios::binary | std::ios::app);
+    file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size()));
+    if (!file.flush()) {
+        std::cerr << "Failed to append to save journal " << journalPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+nlohmann::json SaveWriter::toJson(const SaveState& state) {
+    using json = nlohmann::json;
+    
+    json saveData;
+    saveData["playerName"] = "";
+    saveData["currentScript"] = state.currentScript;
+    saveData["currentScene"] = state.currentScene;
+    
+    json flagsJson = json::object();
+    for (const auto& [key, value] : state.flags) {
+        flagsJson[std::string(symbolName(key))] = value;
+    }
+    saveData["flags"] = flagsJson;
+    
+    json statsJson = json::object();
+    for (const auto& [key, value] : state.stats) {
+        statsJson[std::string(symbolName(key))] = value;
+    }
+    saveData["stats"] = statsJson;
+    
+    json inventoryJson = json::array();
+    for (const auto& item : state.inventory) {
+        inventoryJson.push_back({{"id", std::string(symbolName(item.id))}, {"quantity", item.quantity}});
+    }
+    saveData["inventory"] = inventoryJson;
+    return saveData;
+}
@@ -1,67 +1,333 @@
 // SFML 3.x
 
 #include "SceneManager.h"
+#include "ImageScaling.h"
+#include "ScriptCache.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <unordered_set>
+#include <utility>
 
 SceneManager::SceneManager(ResourceManager& resources)
-    : resources(resources), currentScene(nullptr) {}
+    : resources(resources), script(std::make_shared<const GameScript>()), currentScene(nullptr) {}
+
+SceneManager::~SceneManager() {
+    // Decodes read through resources, which may be destroyed while the pool still runs jobs
+    for (auto& [background, pending] : pendingBackgrounds) {
+        cancelBackground(pending);
+    }
+    for (auto& image : cancelledBackgrounds) {
+        image.wait();
+    }
+}
 
 bool SceneManager::loadScript(const std::string& scriptPath) {
-    // Parse script file
-    auto scriptOpt = ScriptParser::loadScript(scriptPath);
-    if (!scriptOpt) {
+    // Cached (or already prefetched) scripts are swapped in without parsing
+    auto loaded = ScriptCache::global().load(scriptPath);
+    if (!loaded) {
         return false;
     }
     
-    script = *scriptOpt;
+    script = std::move(loaded);
+    currentScene = nullptr;
+    currentSceneIndex = SCENE_NONE;
     
-    std::cout << "Loaded script: " << script.title 
-              << " (Chapter " << script.metadata.chapter << ")" << std::endl;
+    std::cout << "Loaded script: " << script->title 
+              << " (Chapter " << script->metadata.chapter << ")" << std::endl;
     
     // Load first scene
-    return !script.scenes.empty() && loadScene(script.scenes[0].id);
+    return script->sceneCount() > 0 && loadScene(std::uint32_t{0});
 }
 
 bool SceneManager::loadScene(const std::string& sceneId) {
     // Check for script end
     if (sceneId == "END") {
+        return loadScene(SCENE_END);
+    }
+    
+    // Find scene in script
+    std::uint32_t sceneIndex = ScriptParser::findSceneIndex(*script, sceneId);
+    if (sceneIndex == SCENE_NONE) {
+        std::cerr << "Scene not found: " << sceneId << std::endl;
+        return false;
+    }
+    return loadScene(sceneIndex);
+}
+
+bool SceneManager::loadScene(std::uint32_t sceneIndex) {
+    // Check for script end
+    if (sceneIndex == SCENE_END) {
         if (onScriptComplete) {
             onScriptComplete();
         }
         return false;
     }
     
-    // Find scene in script
-    currentScene = ScriptParser::findScene(script, sceneId);
-    if (!currentScene) {
-        std::cerr << "Scene not found: " << sceneId << std::endl;
+    if (sceneIndex >= script->sceneCount()) {
+        std::cerr << "Scene index out of range: " << sceneIndex << std::endl;
         return false;
     }
+    const Scene* scene = script->scene(sceneIndex);
+    if (!scene) {
+        return false;
+    }
+    currentScene = scene;
+    currentSceneIndex = sceneIndex;
     
-    // Load background texture
-    if (!currentScene->background.empty()) {
-        try {
-            // Try to get already loaded texture
-            sf::Texture& texture = resources.getTexture(currentScene->background);
-            graphicsSprite = std::make_unique<sf::Sprite>(texture);
-        } catch (const std::out_of_range&) {
-            // Load texture from file (try .jpeg first, then .png)
-            std::string texturePath = "assets/images/" + currentScene->background + ".jpeg";
-            if (resources.loadTexture(currentScene->background, texturePath)) {
-                graphicsSprite = std::make_unique<sf::Sprite>(resources.getTexture(currentScene->background));
-            } else {
-                texturePath = "assets/images/" + currentScene->background + ".png";
-                if (resources.loadTexture(currentScene->background, texturePath)) {
-                    graphicsSprite = std::make_unique<sf::Sprite>(resources.getTexture(currentScene->background));
-                } else {
-                    std::cerr << "Failed to load texture: " << currentScene->background << std::endl;
-                    graphicsSprite.reset();
-                }
-            }
+    for (const auto& choice : currentScene->choices) {
+        if (!choice.nextScript.empty()) {
+            // Chained scripts parse in the background while the player reads this scene
+            ScriptCache::global().prefetch(std::string(choice.nextScript));
+        } else if (script->lazy && choice.target < script->sceneCount()) {
+            // Lazy scripts: parse every scene this one leads to now, so taking a choice never waits on the parser
+            script->scene(choice.target);
         }
+    }
+    
+    // Load background texture
+    if (currentScene->background != NO_SYMBOL) {
+        showBackground(currentScene->background);
     } else {
         graphicsSprite.reset();
+        backgroundTexture.reset();
     }
     
+    prefetchFrom(sceneIndex);
     return true;
+}
+
+void SceneManager::prefetchFrom(std::uint32_t sceneIndex) {
+    // Breadth-first over visible choices, so backgrounds come out ordered by graph distance.
+    // Decoded sizes from the manifest cap the lookahead at half the texture budget, so
+    // prefetched backgrounds never push each other (or the current one) out of the cache.
+    const std::size_t byteBudget = resources.getTextureStats().budgetBytes / 2;
+    std::size_t wantedBytes = 0;
+    std::vector<Symbol> wanted;
+    std::unordered_set<Symbol> wantedSet;
+    std::unordered_set<std::uint32_t> visited{sceneIndex};
+    std::vector<std::pair<std::uint32_t, int>> queue{{sceneIndex, 0}};
+    
+    for (size_t head = 0; head < queue.size() && wanted.size() < prefetchLimit; ++head) {
+        auto [index, distance] = queue[head];
+        const Scene* scene = script->scene(index);
+        if (!scene) {
+            continue;
+        }
+        
+        if (distance > 0 && scene->background != NO_SYMBOL && !hasFittingTexture(scene->background) &&
+            !wantedSet.count(scene->background)) {
+            sf::Vector2u size = backgroundTargetSize(scene->background);
+            std::size_t bytes = static_cast<std::size_t>(size.x) * size.y * 4;
+            if (!wanted.empty() && wantedBytes + bytes > byteBudget) {
+                break;
+            }
+            wantedBytes += bytes;
+            wantedSet.insert(scene->background);
+            wanted.push_back(scene->background);
+        }
+        if (distance >= prefetchDepth) {
+            continue;
+        }
+        
+        for (const auto& choice : scene->choices) {
+            if (choice.target >= script->sceneCount() ||
+                (choice.condition && choiceFilter && !choiceFilter(*choice.condition))) {
+                continue;
+            }
+            if (visited.insert(choice.target).second) {
+                queue.push_back({choice.target, distance + 1});
+            }
+        }
+    }
+    
+    // Drop work for scenes that can no longer be reached from here
+    for (auto it = pendingBackgrounds.begin(); it != pendingBackgrounds.end();) {
+        if (wantedSet.count(it->first)) {
+            ++it;
+        } else {
+            cancelBackground(it->second);
+            it = pendingBackgrounds.erase(it);
+        }
+    }
+    
+    // The pool runs jobs in FIFO order, so nearer scenes decode first
+    for (Symbol background : wanted) {
+        requestBackground(background);
+    }
+}
+
+void SceneManager::prepareScene(std::uint32_t sceneIndex) {
+    const Scene* scene = script->scene(sceneIndex);
+    if (!scene || scene->background == NO_SYMBOL) {
+        return;
+    }
+    
+    requestBackground(scene->background);
+}
+
+void SceneManager::requestBackground(Symbol background) {
+    if (hasFittingTexture(background) || pendingBackgrounds.count(background)) {
+        return;
+    }
+    
+    // Only the decode (and downscale) runs on the pool; the GPU upload happens in showBackground
+    PendingBackground pending;
+    pending.cancelled = std::make_shared<std::atomic<bool>>(false);
+    pending.image = ThreadPool::shared().submit(
+        [&resources = resources, name = std::string(symbolName(background)), fit = displaySize,
+         cancelled = pending.cancelled]() -> std::optional<sf::Image> {
+            if (cancelled->load()) {
+                return std::nullopt;
+            }
+            return decodeBackground(resources, name, fit);
+        });
+    pendingBackgrounds[background] = std::move(pending);
+}
+
+void SceneManager::cancelBackground(PendingBackground& pending) {
+    pending.cancelled->store(true);
+    if (!pending.image.valid()) {
+        return;
+    }
+    
+    // Forget jobs that have already finished so the list stays short
+    cancelledBackgrounds.erase(
+        std::remove_if(cancelledBackgrounds.begin(), cancelledBackgrounds.end(),
+                       [](const auto& image) {
+                           return image.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                       }),
+        cancelledBackgrounds.end());
+    cancelledBackgrounds.push_back(std::move(pending.image));
+}
+
+void SceneManager::setDisplaySize(sf::Vector2u boxSize) {
+    // Round up to 64px steps so small resizes keep their variant (and hit the decoded image cache)
+    sf::Vector2u quantized((boxSize.x + 63) / 64 * 64, (boxSize.y + 63) / 64 * 64);
+    if (quantized == displaySize) {
+        return;
+    }
+    displaySize = quantized;
+    
+    // Decodes still in flight were sized for the old box
+    for (auto& [background, pending] : pendingBackgrounds) {
+        cancelBackground(pending);
+    }
+    pendingBackgrounds.clear();
+    
+    // The background on screen stays up until its new variant is ready (see update);
+    // cached ones are regenerated when next shown
+    if (currentScene && currentScene->background != NO_SYMBOL) {
+        requestBackground(currentScene->background);
+    }
+    if (currentSceneIndex < script->sceneCount()) {
+        prefetchFrom(currentSceneIndex);
+    }
+}
+
+void SceneManager::update() {
+    if (!currentScene || currentScene->background == NO_SYMBOL || !backgroundTexture) {
+        return;
+    }
+    
+    auto it = pendingBackgrounds.find(currentScene->background);
+    if (it != pendingBackgrounds.end() &&
+        it->second.image.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        showBackground(currentScene->background);
+    }
+}
+
+sf::Vector2u SceneManager::backgroundTargetSize(Symbol background) const {
+    const AssetInfo* asset = backgroundAsset(resources, symbolName(background));
+    if (!asset || asset->width == 0) {
+        return {};
+    }
+    ImageScaling::Size size = ImageScaling::fitWithin({asset->width, asset->height}, {displaySize.x, displaySize.y});
+    return {size.width, size.height};
+}
+
+bool SceneManager::fitsDisplay(Symbol background, sf::Vector2u textureSize) const {
+    sf::Vector2u target = backgroundTargetSize(background);
+    if (target.x == 0) {
+        return true;
+    }
+    // Close enough: never upscaled, and at most a third larger than the box needs
+    return textureSize.x >= target.x && textureSize.x * 3 <= target.x * 4;
+}
+
+bool SceneManager::hasFittingTexture(Symbol background) const {
+    sf::Vector2u size = resources.getTextureSize(background);
+    return size.x > 0 && fitsDisplay(background, size);
+}
+
+bool SceneManager::isSceneReady(std::uint32_t sceneIndex) const {
+    const Scene* scene = script->scene(sceneIndex);
+    if (!scene) {
+        return true;
+    }
+    
+    // A resident texture can be shown right away, even if a better-sized variant is on its way
+    auto it = pendingBackgrounds.find(scene->background);
+    return it == pendingBackgrounds.end() || resources.hasTexture(scene->background) ||
+           it->second.image.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+const AssetInfo* SceneManager::backgroundAsset(const ResourceManager& resources, std::string_view name) {
+    return resources.getManifest().find("images/" + std::string(name));
+}
+
+std::optional<sf::Image> SceneManager::decodeBackground(const ResourceManager& resources, const std::string& name,
+                                                       sf::Vector2u fit) {
+    // The manifest knows the real file, so there is nothing to probe
+    const AssetInfo* asset = backgroundAsset(resources, name);
+    if (!asset) {
+        std::cerr << "Background not in asset manifest: " << name << std::endl;
+        return std::nullopt;
+    }
+    sf::Image image;
+    if (resources.decodeImage(image, asset->path, fit)) {
+        return image;
+    }
+    return std::nullopt;
+}
+
+void SceneManager::showBackground(Symbol background) {
+    TextureHandle texture = resources.acquireTexture(background);
+    auto it = pendingBackgrounds.find(background);
+    bool stale = texture && !fitsDisplay(background, texture->getSize());
+    bool upgradeReady = stale && it != pendingBackgrounds.end() &&
+                        it->second.image.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    
+    if (!texture || upgradeReady) {
+        // Use the prefetched decode if there is one (waiting for it only if it is still running)
+        std::optional<sf::Image> image;
+        if (it != pendingBackgrounds.end()) {
+            image = it->second.image.get();
+            pendingBackgrounds.erase(it);
+        } else {
+            image = decodeBackground(resources, std::string(symbolName(background)), displaySize);
+        }
+        
+        // Uploading replaces a stale variant in place
+        if (image) {
+            if (TextureHandle uploaded = resources.uploadTexture(background, *image)) {
+                texture = std::move(uploaded);
+            }
+        }
+        if (!texture) {
+            std::cerr << "Failed to load texture: " << symbolName(background) << std::endl;
+            graphicsSprite.reset();
+            backgroundTexture.reset();
+            return;
+        }
+    } else if (stale) {
+        // Keep showing the old size while the right one decodes
+        requestBackground(background);
+    }
+    
+    // The handle pins the texture in the cache for as long as it is on screen.
+    // Rebuilt every time since a replaced variant has a different size.
+    graphicsSprite = std::make_unique<sf::Sprite>(*texture);
+    backgroundTexture = std::move(texture);
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "ScriptCache.h"
+#include "ThreadPool.h"
+#include <iostream>
+
+ScriptCache::ScriptCache(std::size_t capacity) : capacity(capacity) {
+    // Construct the pool first so it is destroyed after the cache and still runs the
+    // prefetches the destructor waits for
+    ThreadPool::shared();
+}
+
+ScriptCache::~ScriptCache() {
+    // Prefetch jobs lock mutex and update the cache when they finish
+    for (;;) {
+        std::unordered_map<std::string, std::shared_future<ScriptPtr>> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.swap(inFlight);
+        }
+        if (pending.empty()) {
+            break;
+        }
+        for (auto& [path, script] : pending) {
+            script.wait();
+        }
+    }
+}
+
+ScriptCache& ScriptCache::global() {
+    static ScriptCache cache;
+    return cache;
+}
+
+ScriptCache::FileTime ScriptCache::modifiedTime(const std::string& path) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    return ec ? FileTime::min() : time;
+}
+
+ScriptCache::ScriptPtr ScriptCache::parse(const std::string& path) {
+    auto script = ScriptParser::loadScript(path);
+    if (!script) {
+        return nullptr;
+    }
+    return std::make_shared<const GameScript>(std::move(*script));
+}
+
+ScriptCache::ScriptPtr ScriptCache::findFresh(const std::string& path, FileTime modified) {
+    auto it = lookup.find(path);
+    if (it == lookup.end()) {
+        return nullptr;
+    }
+
+    // Drop entries whose file changed since they were parsed
+    if (it->second->modified != modified) {
+        entries.erase(it->second);
+        lookup.erase(it);
+        return nullptr;
+    }
+
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->script;
+}
+
+void ScriptCache::insert(const std::string& path, FileTime modified, ScriptPtr script) {
+    auto it = lookup.find(path);
+    if (it != lookup.end()) {
+        entries.erase(it->second);
+        lookup.erase(it);
+    }
+
+    entries.push_front(Entry{path, modified, std::move(script)});
+    lookup[path] = entries.begin();
+
+    while (entries.size() > capacity) {
+        lookup.erase(entries.back().path);
+        entries.pop_back();
+    }
+}
+
+std::shared_ptr<const GameScript> ScriptCache::load(const std::string& path) {
+    FileTime modified = modifiedTime(path);
+    std::shared_future<ScriptPtr> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto script = findFresh(path, modified)) {
+            return script;
+        }
+        auto it = inFlight.find(path);
+        if (it != inFlight.end()) {
+            pending = it->second;
+        }
+    }
+
+    // A prefetch is already parsing this script; its result is inserted by the worker
+    if (pending.valid()) {
+        if (auto script = pending.get()) {
+            return script;
+        }
+    }
+
+    ScriptPtr script = parse(path);
+    if (script) {
+        std::lock_guard<std::mutex> lock(mutex);
+        insert(path, modified, script);
+    }
+    return script;
+}
+
+void ScriptCache::prefetch(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    FileTime modified = modifiedTime(path);
+    if (findFresh(path, modified) || inFlight.count(path)) {
+        return;
+    }
+
+    // The worker needs the mutex to finish, so registering the future here cannot race it
+    inFlight[path] = ThreadPool::shared().submit([this, path, modified]() {
+        ScriptPtr script = parse(path);
+        std::lock_guard<std::mutex> workerLock(mutex);
+        inFlight.erase(path);
+        if (script) {
+            insert(path, modified, script);
+        } else {
+            std::cerr << "Background load failed for script: " << path << std::endl;
+        }
+        return script;
+    }).share();
+}
+
+void ScriptCache::setCapacity(std::size_t newCapacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = newCapacity;
+    while (entries.size() > capacity) {
+        lookup.erase(entries.back().path);
+        entries.pop_back();
+    }
+}
+
+void ScriptCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lookup.clear();
+}
@@ -0,0 +1,148 @@
+#include "ScriptCompiler.h"
+#include "ScriptFormat.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace {
+
+using namespace ScriptFormat;
+
+// Builds the deduplicated string pool while the tables are being filled
+class PoolBuilder {
+public:
+    StrRef add(std::string_view s) {
+        if (s.empty()) {
+            return {};
+        }
+        auto it = offsets.find(std::string(s));
+        if (it != offsets.end()) {
+            return {it->second, static_cast<std::uint32_t>(s.size())};
+        }
+        StrRef ref{static_cast<std::uint32_t>(bytes.size()), static_cast<std::uint32_t>(s.size())};
+        bytes.append(s.data(), s.size());
+        offsets.emplace(std::string(s), ref.offset);
+        return ref;
+    }
+    
+    const std::string& data() const { return bytes; }
+
+private:
+    std::string bytes;
+    std::unordered_map<std::string, std::uint32_t> offsets;
+};
+
+template <typename T>
+void writeTable(std::ofstream& out, const std::vector<T>& table) {
+    if (!table.empty()) {
+        out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(T));
+    }
+}
+
+} // namespace
+
+bool ScriptCompiler::compile(const GameScript& script, const std::string& path) {
+    PoolBuilder pool;
+    std::vector<SceneRecord> scenes;
+    std::vector<ChoiceRecord> choices;
+    std::vector<EffectRecord> effects;
+    std::vector<StrRef> unlocks;
+    
+    for (std::uint32_t i = 0; i < script.sceneCount(); ++i) {
+        const Scene* scenePtr = script.scene(i);
+        if (!scenePtr) {
+            std::cerr << "Cannot compile malformed scene " << i << " of " << script.scriptId << std::endl;
+            return false;
+        }
+        const Scene& scene = *scenePtr;
+        
+        SceneRecord rec{};
+        rec.id = pool.add(scene.id);
+        rec.background = pool.add(symbolName(scene.background));
+        rec.text = pool.add(scene.text);
+        rec.speaker = pool.add(scene.speaker);
+        rec.speakerColor = pool.add(scene.speakerColor);
+        
+        rec.firstChoice = static_cast<std::uint32_t>(choices.size());
+        rec.choiceCount = static_cast<std::uint32_t>(scene.choices.size());
+        for (const auto& choice : scene.choices) {
+            ChoiceRecord choiceRec{};
+            choiceRec.text = pool.add(choice.text);
+            choiceRec.nextScene = pool.add(choice.nextScene);
+            choiceRec.nextScript = pool.add(choice.nextScript);
+            if (choice.condition) {
+                choiceRec.flags |= ChoiceHasCondition;
+                choiceRec.conditionFlag = pool.add(symbolName(choice.condition->flag));
+                choiceRec.conditionFlagsNot = pool.add(symbolName(choice.condition->flagsNot));
+                choiceRec.conditionExpr = pool.add(choice.condition->expression);
+            }
+            choices.push_back(choiceRec);
+        }
+        
+        // One op per effect step, already in apply order
+        rec.firstEffect = static_cast<std::uint32_t>(effects.size());
+        if (scene.effects) {
+            const Effects& eff = *scene.effects;
+            rec.flags |= SceneHasEffects;
+            for (const EffectStep& step : eff.steps) {
+                EffectOp op = EffectOp::AddFlag;
+                switch (step.op) {
+                    case EffectStep::Op::SetFlag:    op = EffectOp::AddFlag; break;
+                    case EffectStep::Op::ClearFlag:  op = EffectOp::RemoveFlag; break;
+                    case EffectStep::Op::AddStat:    op = EffectOp::ModifyStat; break;
+                    case EffectStep::Op::AddItem:    op = EffectOp::AddItem; break;
+                    case EffectStep::Op::RemoveItem: op = EffectOp::RemoveItem; break;
+                }
+                effects.push_back({op, pool.add(symbolName(step.target)), step.amount});
+            }
+        }
+        rec.effectCount = static_cast<std::uint32_t>(effects.size()) - rec.firstEffect;
+        
+        scenes.push_back(rec);
+    }
+    
+    for (const auto& unlock : script.metadata.unlocks) {
+        unlocks.push_back(pool.add(unlock));
+    }
+    
+    ScriptHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.sceneCount = static_cast<std::uint32_t>(scenes.size());
+    header.choiceCount = static_cast<std::uint32_t>(choices.size());
+    header.effectCount = static_cast<std::uint32_t>(effects.size());
+    header.unlockCount = static_cast<std::uint32_t>(unlocks.size());
+    header.scriptId = pool.add(script.scriptId);
+    header.title = pool.add(script.title);
+    header.estimatedTime = pool.add(script.metadata.estimatedTime);
+    header.chapter = script.metadata.chapter;
+    
+    // Tables are laid out back to back after the header, string pool last
+    std::uint32_t offset = sizeof(ScriptHeader);
+    header.sceneTableOffset = offset;
+    offset += static_cast<std::uint32_t>(scenes.size() * sizeof(SceneRecord));
+    header.choiceTableOffset = offset;
+    offset += static_cast<std::uint32_t>(choices.size() * sizeof(ChoiceRecord));
+    header.effectTableOffset = offset;
+    offset += static_cast<std::uint32_t>(effects.size() * sizeof(EffectRecord));
+    header.unlockTableOffset = offset;
+    offset += static_cast<std::uint32_t>(unlocks.size() * sizeof(StrRef));
+    header.stringPoolOffset = offset;
+    header.stringPoolSize = static_cast<std::uint32_t>(pool.data().size());
+    
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to write compiled script: " << path << std::endl;
+        return false;
+    }
+    
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeTable(out, scenes);
+    writeTable(out, choices);
+    writeTable(out, effects);
+    writeTable(out, unlocks);
+    out.write(pool.data().data(), pool.data().size());
+    
+    return static_cast<bool>(out);
+}
@@ -1,13 +1,389 @@
 // SFML 3.x
 
 #include "ScriptParser.h"
+#include "ScriptFormat.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
+namespace {
+
+// Interned id for an optional name field (empty stays NO_SYMBOL)
+Symbol internOptional(std::string_view name) {
+    return name.empty() ? NO_SYMBOL : intern(name);
+}
+
+// Resolve the Choice::target of every choice in scene against the script's index
+bool resolveTargets(const GameScript& script, Scene& scene) {
+    bool allResolved = true;
+    for (auto& choice : scene.choices) {
+        // Script-chaining choices start the next script at its first scene
+        if (!choice.nextScript.empty()) {
+            choice.target = SCENE_NONE;
+            continue;
+        }
+        if (choice.nextScene == "END") {
+            choice.target = SCENE_END;
+            continue;
+        }
+        
+        choice.target = script.index.find(SymbolTable::global().find(choice.nextScene));
+        if (choice.target == SCENE_NONE) {
+            std::cerr << "Unresolved scene target in " << script.scriptId << ": '"
+                      << scene.id << "' -> '" << choice.nextScene << "'" << std::endl;
+            allResolved = false;
+        }
+    }
+    return allResolved;
+}
+
+// Builds a GameScript straight from SAX events, mirroring the DOM walk in loadJsonScriptDom.
+// Unknown keys (and everything nested under them) are skipped.
+class ScriptSaxHandler {
+public:
+    using string_t = json::string_t;
+    using number_integer_t = json::number_integer_t;
+    using number_unsigned_t = json::number_unsigned_t;
+    using number_float_t = json::number_float_t;
+    using binary_t = json::binary_t;
+    
+    // With singleScene the input is one scene object, appended to script.scenes
+    ScriptSaxHandler(GameScript& script, StringPool& pool, bool singleScene = false)
+        : script(script), pool(pool) {
+        if (singleScene) {
+            stack.push_back(Ctx::Scenes);
+        }
+    }
+    
+    const std::string& error() const { return errorMessage; }
+    
+    bool null() { return scalar(); }
+    bool boolean(bool) { return scalar(); }
+    bool number_integer(number_integer_t value) { return number(static_cast<long long>(value)); }
+    bool number_unsigned(number_unsigned_t value) { return number(static_cast<long long>(value)); }
+    bool number_float(number_float_t value, const string_t&) { return number(static_cast<long long>(value)); }
+    bool binary(binary_t&) { return scalar(); }
+    
+    bool string(string_t& value) {
+        switch (top()) {
+            case Ctx::Root:
+                if (currentKey == "scriptId") { script.scriptId = value; seen |= SEEN_SCRIPT_ID; }
+                else if (currentKey == "title") { script.title = value; seen |= SEEN_TITLE; }
+                return true;
+            case Ctx::Metadata:
+                if (currentKey == "estimatedTime") script.metadata.estimatedTime = value;
+                return true;
+            case Ctx::Unlocks:
+                script.metadata.unlocks.push_back(value);
+                return true;
+            case Ctx::Scene:
+                if (currentKey == "id") { scene.id = pool.add(value); sceneFields |= FIELD_A; }
+                else if (currentKey == "background") { scene.background = internOptional(value); sceneFields |= FIELD_B; }
+                else if (currentKey == "text") { scene.text = pool.add(value); sceneFields |= FIELD_C; }
+                else if (currentKey == "speaker") { scene.speaker = pool.add(value); sceneFields |= FIELD_D; }
+                else if (currentKey == "speakerColor") scene.speakerColor = pool.add(value);
+                return true;
+            case Ctx::Choice:
+                if (currentKey == "text") { choice.text = pool.add(value); choiceFields |= FIELD_A; }
+                else if (currentKey == "nextScene") { choice.nextScene = pool.add(value); choiceFields |= FIELD_B; }
+                else if (currentKey == "nextScript") choice.nextScript = pool.add(value);
+                return true;
+            case Ctx::Condition:
+                if (currentKey == "flag") condition.flag = internOptional(value);
+                else if (currentKey == "flagsNot") condition.flagsNot = internOptional(value);
+                else if (currentKey == "expr") condition.expression = pool.add(value);
+                return true;
+            case Ctx::Effects:
+            case Ctx::FlagList:
+                // Inside a flag list the key is still the list's
+                if (currentKey == "addFlag") effects.add(EffectStep::Op::SetFlag, internOptional(value));
+                else if (currentKey == "removeFlag") effects.add(EffectStep::Op::ClearFlag, internOptional(value));
+                return true;
+            case Ctx::ItemEntry:
+                if (currentKey == "id") itemId = value;
+                else if (currentKey == "quantity") return fail("item quantity must be a number");
+                return true;
+            case Ctx::ModifyStat:
+                return fail("stat modifier '" + currentKey + "' must be a number");
+            default:
+                return true;
+        }
+    }
+    
+    bool start_object(std::size_t) {
+        if (stack.empty()) {
+            stack.push_back(Ctx::Root);
+            return true;
+        }
+        
+        Ctx next = Ctx::Skip;
+        switch (top()) {
+            case Ctx::Root:
+                if (currentKey == "metadata") next = Ctx::Metadata;
+                break;
+            case Ctx::Scenes:
+                scene = Scene{};
+                scene.speakerColor = "#ffffffff";  // Default white color
+                sceneFields = 0;
+                next = Ctx::Scene;
+                break;
+            case Ctx::Choices:
+                choice = Choice{};
+                choiceFields = 0;
+                next = Ctx::Choice;
+                break;
+            case Ctx::Choice:
+                if (currentKey == "condition") {
+                    condition = Condition{};
+                    next = Ctx::Condition;
+                }
+                break;
+            case Ctx::Scene:
+                if (currentKey == "effects") {
+                    effects = Effects{};
+                    next = Ctx::Effects;
+                }
+                break;
+            case Ctx::Effects:
+                if (currentKey == "modifyStat") next = Ctx::ModifyStat;
+                break;
+            case Ctx::ItemList:
+                itemId.clear();
+                itemQuantity = 1;
+                next = Ctx::ItemEntry;
+                break;
+            default:
+                break;
+        }
+        stack.push_back(next);
+        return true;
+    }
+    
+    bool key(string_t& value) {
+        currentKey = value;
+        return true;
+    }
+    
+    bool end_object() {
+        Ctx ctx = top();
+        stack.pop_back();
+        
+        switch (ctx) {
+            case Ctx::Root:
+                if ((seen & (SEEN_SCRIPT_ID | SEEN_TITLE | SEEN_SCENES)) != (SEEN_SCRIPT_ID | SEEN_TITLE | SEEN_SCENES)) {
+                    return fail("script requires scriptId, title and scenes");
+                }
+                return true;
+            case Ctx::Scene:
+                if (sceneFields != (FIELD_A | FIELD_B | FIELD_C | FIELD_D | FIELD_E)) {
+                    return fail("scene requires id, background, text, speaker and choices");
+                }
+                scene.symbol = intern(scene.id);
+                script.scenes.push_back(std::move(scene));
+                return true;
+            case Ctx::Choice:
+                if (choiceFields != (FIELD_A | FIELD_B)) {
+                    return fail("choice requires text and nextScene");
+                }
+                scene.choices.push_back(choice);
+                return true;
+            case Ctx::Condition: {
+                std::string error;
+                if (!condition.compile(error)) {
+                    return fail("condition: " + error);
+                }
+                choice.condition = condition;
+                return true;
+            }
+            case Ctx::Effects:
+                effects.sort();
+                scene.effects = std::move(effects);
+                return true;
+            case Ctx::ItemEntry:
+                if (!itemId.empty()) {
+                    effects.add(addingItems ? EffectStep::Op::AddItem : EffectStep::Op::RemoveItem,
+                                intern(itemId), itemQuantity);
+                }
+                return true;
+            default:
+                return true;
+        }
+    }
+    
+    bool start_array(std::size_t) {
+        Ctx next = Ctx::Skip;
+        switch (top()) {
+            case Ctx::Root:
+                if (currentKey == "scenes") { next = Ctx::Scenes; seen |= SEEN_SCENES; }
+                break;
+            case Ctx::Metadata:
+                if (currentKey == "unlocks") next = Ctx::Unlocks;
+                break;
+            case Ctx::Scene:
+                if (currentKey == "choices") { next = Ctx::Choices; sceneFields |= FIELD_E; }
+                break;
+            case Ctx::Effects:
+                if (currentKey == "addItems" || currentKey == "removeItems") {
+                    addingItems = (currentKey == "addItems");
+                    next = Ctx::ItemList;
+                } else if (currentKey == "addFlag" || currentKey == "removeFlag") {
+                    next = Ctx::FlagList;
+                }
+                break;
+            default:
+                break;
+        }
+        stack.push_back(next);
+        return true;
+    }
+    
+    bool end_array() {
+        stack.pop_back();
+        return true;
+    }
+    
+    bool parse_error(std::size_t, const std::string&, const json::exception& e) {
+        return fail(e.what());
+    }
+
+private:
+    enum class Ctx {
+        Root, Metadata, Unlocks, Scenes, Scene, Choices, Choice, Condition,
+        Effects, FlagList, ModifyStat, ItemList, ItemEntry, Skip
+    };
+    
+    // Required-field bits
+    enum : unsigned { SEEN_SCRIPT_ID = 1, SEEN_TITLE = 2, SEEN_SCENES = 4 };
+    enum : unsigned { FIELD_A = 1, FIELD_B = 2, FIELD_C = 4, FIELD_D = 8, FIELD_E = 16 };
+    
+    Ctx top() const { return stack.empty() ? Ctx::Skip : stack.back(); }
+    
+    bool number(long long value) {
+        switch (top()) {
+            case Ctx::Metadata:
+                if (currentKey == "chapter") script.metadata.chapter = static_cast<int>(value);
+                return true;
+            case Ctx::ModifyStat:
+                effects.add(EffectStep::Op::AddStat, intern(currentKey), static_cast<std::int32_t>(value));
+                return true;
+            case Ctx::ItemEntry:
+                if (currentKey == "quantity") itemQuantity = static_cast<int>(value);
+                else if (currentKey == "id") return fail("item id must be a string");
+                return true;
+            default:
+                return scalar();
+        }
+    }
+    
+    // Non-string, non-number values are only valid where the DOM walk ignores them
+    bool scalar() {
+        switch (top()) {
+            case Ctx::Root:
+                return (currentKey == "scriptId" || currentKey == "title") ? fail(currentKey + " must be a string") : true;
+            case Ctx::Scene:
+                return (currentKey == "id" || currentKey == "background" || currentKey == "text" || currentKey == "speaker")
+                    ? fail("scene " + currentKey + " must be a string") : true;
+            case Ctx::Choice:
+                return (currentKey == "text" || currentKey == "nextScene") ? fail("choice " + currentKey + " must be a string") : true;
+            case Ctx::ModifyStat:
+                return fail("stat modifier '" + currentKey + "' must be a number");
+            case Ctx::FlagList:
+                return fail(currentKey + " entries must be strings");
+            default:
+                return true;
+        }
+    }
+    
+    bool fail(std::string message) {
+        errorMessage = std::move(message);
+        return false;
+    }
+    
+    GameScript& script;
+    StringPool& pool;
+    std::vector<Ctx> stack;
+    std::string currentKey;
+    std::string errorMessage;
+    unsigned seen = 0;
+    
+    // Objects currently being filled
+    Scene scene;
+    unsigned sceneFields = 0;
+    Choice choice;
+    unsigned choiceFields = 0;
+    Condition condition;
+    Effects effects;
+    std::string itemId;
+    int itemQuantity = 1;
+    bool addingItems = true;
+};
+
+} // namespace
+
+std::string_view StringPool::add(std::string_view s) {
+    if (s.empty()) {
+        return {};
+    }
+    
+    // Start a new block when the current one is full (oversized strings get their own)
+    if (blockUsed + s.size() > blockCapacity) {
+        blockCapacity = std::max(BLOCK_SIZE, s.size());
+        blocks.push_back(std::make_unique<char[]>(blockCapacity));
+        blockUsed = 0;
+    }
+    
+    char* dest = blocks.back().get() + blockUsed;
+    std::memcpy(dest, s.data(), s.size());
+    blockUsed += s.size();
+    return std::string_view(dest, s.size());
+}
+
+std::string ScriptParser::compiledPathFor(const std::string& path) {
+    return std::filesystem::path(path).replace_extension(ScriptFormat::kExtension).string();
+}
+
 std::optional<GameScript> ScriptParser::loadScript(const std::string& path) {
+    // Use the compiled script only if it is at least as new as the JSON it was built from
+    std::string compiledPath = compiledPathFor(path);
+    std::error_code ec;
+    auto compiledTime = std::filesystem::last_write_time(compiledPath, ec);
+    if (!ec) {
+        std::error_code jsonEc;
+        auto jsonTime = std::filesystem::last_write_time(path, jsonEc);
+        if (jsonEc || compiledTime >= jsonTime) {
+            if (auto script = loadCompiledScript(compiledPath)) {
+                return script;
+            }
+            std::cerr << "Falling back to JSON script: " << path << std::endl;
+        }
+    }
+    
+    // Huge chapter files: only parse the scenes the player actually reaches
+    std::error_code sizeEc;
+    auto jsonSize = std::filesystem::file_size(path, sizeEc);
+    if (!sizeEc && jsonSize >= LAZY_LOAD_THRESHOLD) {
+        return loadLazyScript(path);
+    }
+    
+    return loadJsonScript(path);
+}
+
+std::optional<GameScript> ScriptParser::loadJsonScript(const std::string& path, JsonParseMode mode) {
+    if (mode == JsonParseMode::Dom) {
+        return loadJsonScriptDom(path);
+    }
+    return loadJsonScriptStreaming(path);
+}
+
+std::optional<GameScript> ScriptParser::loadJsonScriptDom(const std::string& path) {
     std::ifstream file(path);
     if (!file.is_open()) {
         std::cerr << "Failed to open script file: " << path << std::endl;
@@ -18,7 +394,16 @@ std::optional<GameScript> ScriptParser::loadScript(const std::string& path) {
         json j;
         file >> j;
 
+        auto pool = std::make_shared<StringPool>();
+        auto str = [&pool](const json& value) {
+            return pool->add(value.get_ref<const std::string&>());
+        };
+        auto sym = [](const json& value) {
+            return internOptional(value.get_ref<const std::string&>());
+        };
+        
         GameScript script;
+        script.storage = pool;
         script.scriptId = j["scriptId"];
         script.title = j["title"];
 
@@ -41,14 +426,15 @@ std::optional<GameScript> ScriptParser::loadScript(const std::string& path) {
         // Parse each scene
         for (const auto& sceneJson : j["scenes"]) {
             Scene scene;
-            scene.id = sceneJson["id"];
-            scene.background = sceneJson["background"];
-            scene.text = sceneJson["text"];
-            scene.speaker = sceneJson["speaker"];
+            scene.id = str(sceneJson["id"]);
+            scene.symbol = intern(scene.id);
+            scene.background = sym(sceneJson["background"]);
+            scene.text = str(sceneJson["text"]);
+            scene.speaker = str(sceneJson["speaker"]);
 
             // Parse speaker color if present, default to white
             if (sceneJson.contains("speakerColor")) {
-                scene.speakerColor = sceneJson["speakerColor"];
+                scene.speakerColor = str(sceneJson["speakerColor"]);
             } else {
                 scene.speakerColor = "#ffffffff";  // Default white color
             }
@@ -56,12 +442,12 @@ std::optional<GameScript> ScriptParser::loadScript(const std::string& path) {
             // Parse choices
             for (const auto& choiceJson : sceneJson["choices"]) {
                 Choice choice;
-                choice.text = choiceJson["text"];
-                choice.nextScene = choiceJson["nextScene"];
+                choice.text = str(choiceJson["text"]);
+                choice.nextScene = str(choiceJson["nextScene"]);
 
                 // Check for nextScript (script chaining)
                 if (choiceJson.contains("nextScript")) {
-                    choice.nextScript = choiceJson["nextScript"];
+                    choice.nextScript = str(choiceJson["nextScript"]);
                 }
 
                 // Parse conditions for showing/hiding choices
@@ -69,10 +455,18 @@ std::optional<GameScript> ScriptParser::loadScript(const std::string& path) {
                     Condition cond;
                     const auto& condJson = choiceJson["condition"];
                     if (condJson.contains("flag")) {
-                        cond.flag = condJson["flag"];
+                        cond.flag = sym(condJson["flag"]);
                     }
                     if (condJson.contains("flagsNot")) {
-                        cond.flagsNot = condJson["flagsNot"];
+                        cond.flagsNot = sym(condJson["flagsNot"]);
+                    }
+                    if (condJson.contains("expr")) {
+                        cond.expression = str(condJson["expr"]);
+                    }
+                    std::string error;
+                    if (!cond.compile(error)) {
+                        std::cerr << "Invalid condition in " << path << ": " << error << std::endl;
+                        return std::nullopt;
                     }
                     choice.condition = cond;
                 }
@@ -85,17 +479,26 @@ std::optional<GameScript> ScriptParser::loadScript(const std::string& path) {
                 Effects eff;
                 const auto& effJson = sceneJson["effects"];
                 
-                if (effJson.contains("addFlag")) {
-                    eff.addFlag = effJson["addFlag"];
-                }
-                
-                if (effJson.contains("removeFlag")) {
-                    eff.removeFlag = effJson["removeFlag"];
-                }
+                // addFlag/removeFlag: a name or an array of names
+                auto flags = [&](const char* key, EffectStep::Op op) {
+                    if (!effJson.contains(key)) {
+                        return;
+                    }
+                    const auto& names = effJson[key];
+                    if (names.is_array()) {
+                        for (const auto& name : names) {
+                            eff.add(op, sym(name));
+                        }
+                    } else {
+                        eff.add(op, sym(names));
+                    }
+                };
+                flags("addFlag", EffectStep::Op::SetFlag);
+                flags("removeFlag", EffectStep::Op::ClearFlag);
                 
                 if (effJson.contains("modifyStat")) {
                     for (auto& [key, val] : effJson["modifyStat"].items()) {
-                        eff.modifyStats[key] = val;
+                        eff.add(EffectStep::Op::AddStat, intern(key), val.get<int>());
                     }
                 }
                 
@@ -104,7 +507,7 @@ std::optional<GameScript> ScriptParser::loadScript(const std::string& path) {
                         std::string itemId = itemJson.value("id", "");
                         int quantity = itemJson.value("quantity", 1);
                         if (!itemId.empty()) {
-                            eff.addItems.push_back({itemId, quantity});
+                            eff.add(EffectStep::Op::AddItem, intern(itemId), quantity);
                         }
                     }
                 }
@@ -114,17 +517,19 @@ std::optional<GameScript> ScriptParser::loadScript(const std::string& path) {
                         std::string itemId = itemJson.value("id", "");
                         int quantity = itemJson.value("quantity", 1);
                         if (!itemId.empty()) {
-                            eff.removeItems.push_back({itemId, quantity});
+                            eff.add(EffectStep::Op::RemoveItem, intern(itemId), quantity);
                         }
                     }
                 }
-                                
-                scene.effects = eff;
+                
+                eff.sort();
+                scene.effects = std::move(eff);
             }
 
-            script.scenes.push_back(scene);
+            script.scenes.push_back(std::move(scene));
         }
 
+        link(script);
         return script;
     } catch (const json::exception& e) {
         std::cerr << "JSON parsing error: " << e.what() << std::endl;
@@ -132,12 +537,517 @@ std::optional<GameScript> ScriptParser::loadScript(const std::string& path) {
     }
 }
 
-const Scene* ScriptParser::findScene(const GameScript& script, const std::string& sceneId) {
-    // Linear search for scene with matching ID
-    for (const auto& scene : script.scenes) {
-        if (scene.id == sceneId) {
-            return &scene;
+std::optional<GameScript> ScriptParser::loadJsonScriptStreaming(const std::string& path) {
+    // Parse straight out of the mapping: no stream buffer and no document tree
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "Failed to open script file: " << path << std::endl;
+        return std::nullopt;
+    }
+    
+    auto pool = std::make_shared<StringPool>();
+    GameScript script;
+    script.storage = pool;
+    
+    ScriptSaxHandler handler(script, *pool);
+    const char* begin = reinterpret_cast<const char*>(file.data());
+    if (!json::sax_parse(begin, begin + file.size(), &handler)) {
+        std::cerr << "JSON parsing error: " << handler.error() << std::endl;
+        return std::nullopt;
+    }
+    
+    link(script);
+    return script;
+}
+
+// Byte ranges of every scene object in a mapped JSON script, plus the scenes parsed so far.
+// Parsed scenes are never evicted, so pointers handed out stay valid for the table's lifetime.
+class LazySceneTable {
+public:
+    struct Span {
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+    
+    MappedFile file;
+    std::vector<Span> spans;  // In scene order, parallel to the ids the index was built from
+    
+    const Scene* get(const GameScript& script, std::uint32_t index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        
+        auto it = parsed.find(index);
+        if (it != parsed.end()) {
+            return &it->second;
+        }
+        
+        // Run the streaming handler over just this scene's object
+        GameScript scratch;
+        ScriptSaxHandler handler(scratch, pool, true);
+        const char* data = reinterpret_cast<const char*>(file.data());
+        const Span& span = spans[index];
+        if (!json::sax_parse(data + span.begin, data + span.end, &handler) || scratch.scenes.size() != 1) {
+            std::cerr << "JSON parsing error in scene " << index << " of " << script.scriptId
+                      << ": " << handler.error() << std::endl;
+            return nullptr;
+        }
+        
+        Scene& scene = parsed.emplace(index, std::move(scratch.scenes.front())).first->second;
+        resolveTargets(script, scene);
+        return &scene;
+    }
+    
+private:
+    std::mutex mutex;
+    StringPool pool;
+    std::unordered_map<std::uint32_t, Scene> parsed;
+};
+
+namespace {
+
+// Minimal structural JSON scanner used to find scene boundaries without tokenizing their contents.
+// It only tracks strings and nesting; each scene is fully validated when it is parsed.
+class JsonScanner {
+public:
+    JsonScanner(const char* data, std::size_t size) : data(data), pos(0), size(size) {}
+    
+    std::size_t offset() const { return pos; }
+    
+    void skipWhitespace() {
+        while (pos < size && (data[pos] == ' ' || data[pos] == '\n' || data[pos] == '\r' || data[pos] == '\t')) {
+            ++pos;
+        }
+    }
+    
+    // Consume c (after whitespace) if it is next
+    bool consume(char c) {
+        skipWhitespace();
+        if (pos < size && data[pos] == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+    
+    bool peek(char c) {
+        skipWhitespace();
+        return pos < size && data[pos] == c;
+    }
+    
+    // Read a string token, decoding escapes only when there are any
+    bool readString(std::string& out) {
+        std::size_t start = pos;
+        if (!skipString()) {
+            return false;
+        }
+        std::string_view token(data + start, pos - start);
+        if (token.find('\\') == std::string_view::npos) {
+            out.assign(token.substr(1, token.size() - 2));
+            return true;
+        }
+        json decoded = json::parse(token, nullptr, false);
+        if (!decoded.is_string()) {
+            return false;
+        }
+        out = decoded.get<std::string>();
+        return true;
+    }
+    
+    // Skip any value, returning false on truncated or malformed input
+    bool skipValue() {
+        skipWhitespace();
+        if (pos >= size) {
+            return false;
+        }
+        
+        char c = data[pos];
+        if (c == '"') {
+            return skipString();
+        }
+        if (c != '{' && c != '[') {
+            // Number, true, false or null
+            while (pos < size && data[pos] != ',' && data[pos] != '}' && data[pos] != ']' &&
+                   data[pos] != ' ' && data[pos] != '\n' && data[pos] != '\r' && data[pos] != '\t') {
+                ++pos;
+            }
+            return true;
+        }
+        
+        int depth = 0;
+        while (pos < size) {
+            c = data[pos];
+            if (c == '"') {
+                if (!skipString()) {
+                    return false;
+                }
+                continue;
+            }
+            ++pos;
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+    
+private:
+    bool skipString() {
+        skipWhitespace();
+        if (pos >= size || data[pos] != '"') {
+            return false;
+        }
+        ++pos;
+        while (pos < size) {
+            const void* hit = std::memchr(data + pos, '"', size - pos);
+            if (!hit) {
+                return false;
+            }
+            std::size_t quote = static_cast<const char*>(hit) - data;
+            
+            // The quote is escaped if it follows an odd run of backslashes
+            std::size_t backslashes = 0;
+            while (quote - backslashes > pos && data[quote - backslashes - 1] == '\\') {
+                ++backslashes;
+            }
+            pos = quote + 1;
+            if (backslashes % 2 == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    const char* data;
+    std::size_t pos;
+    std::size_t size;
+};
+
+} // namespace
+
+std::optional<GameScript> ScriptParser::loadLazyScript(const std::string& path) {
+    auto table = std::make_shared<LazySceneTable>();
+    if (!table->file.open(path)) {
+        std::cerr << "Failed to open script file: " << path << std::endl;
+        return std::nullopt;
+    }
+    
+    GameScript script;
+    script.lazy = table;
+    std::vector<Symbol> sceneIds;
+    bool hasScriptId = false;
+    bool hasTitle = false;
+    bool hasScenes = false;
+    
+    const char* data = reinterpret_cast<const char*>(table->file.data());
+    JsonScanner scanner(data, table->file.size());
+    auto fail = [&path](const char* what) -> std::optional<GameScript> {
+        std::cerr << "JSON parsing error: " << what << " in " << path << std::endl;
+        return std::nullopt;
+    };
+    
+    if (!scanner.consume('{')) {
+        return fail("script must be an object");
+    }
+    
+    std::string key;
+    while (!scanner.consume('}')) {
+        if (!scanner.readString(key) || !scanner.consume(':')) {
+            return fail("malformed top-level key");
+        }
+        
+        if (key != "scenes") {
+            // Header values are small, so they go through the regular parser
+            scanner.skipWhitespace();
+            std::size_t start = scanner.offset();
+            if (!scanner.skipValue()) {
+                return fail("malformed top-level value");
+            }
+            try {
+                json value = json::parse(data + start, data + scanner.offset());
+                if (key == "scriptId") {
+                    script.scriptId = value.get<std::string>();
+                    hasScriptId = true;
+                } else if (key == "title") {
+                    script.title = value.get<std::string>();
+                    hasTitle = true;
+                } else if (key == "metadata") {
+                    script.metadata.chapter = value.value("chapter", script.metadata.chapter);
+                    if (value.contains("unlocks")) {
+                        for (const auto& unlock : value["unlocks"]) {
+                            script.metadata.unlocks.push_back(unlock);
+                        }
+                    }
+                    script.metadata.estimatedTime = value.value("estimatedTime", std::string());
+                }
+            } catch (const json::exception& e) {
+                return fail(e.what());
+            }
+        } else {
+            // Record each scene's byte range and id
+            if (!scanner.consume('[')) {
+                return fail("scenes must be an array");
+            }
+            hasScenes = true;
+            while (!scanner.consume(']')) {
+                scanner.skipWhitespace();
+                LazySceneTable::Span span;
+                span.begin = scanner.offset();
+                if (!scanner.consume('{')) {
+                    return fail("scene must be an object");
+                }
+                
+                std::string sceneId;
+                std::string field;
+                while (!scanner.consume('}')) {
+                    if (!scanner.readString(field) || !scanner.consume(':')) {
+                        return fail("malformed scene key");
+                    }
+                    bool ok = (field == "id" && scanner.peek('"')) ? scanner.readString(sceneId) : scanner.skipValue();
+                    if (!ok) {
+                        return fail("malformed scene value");
+                    }
+                    scanner.consume(',');
+                }
+                if (sceneId.empty()) {
+                    return fail("scene requires id");
+                }
+                
+                span.end = scanner.offset();
+                table->spans.push_back(span);
+                sceneIds.push_back(intern(sceneId));
+                scanner.consume(',');
+            }
+        }
+        scanner.consume(',');
+    }
+    
+    if (!hasScriptId || !hasTitle || !hasScenes) {
+        return fail("script requires scriptId, title and scenes");
+    }
+    
+    script.index.build(sceneIds);
+    return script;
+}
+
+std::uint32_t GameScript::sceneCount() const {
+    return static_cast<std::uint32_t>(lazy ? lazy->spans.size() : scenes.size());
+}
+
+const Scene* GameScript::scene(std::uint32_t index) const {
+    if (index >= sceneCount()) {
+        return nullptr;
+    }
+    return lazy ? lazy->get(*this, index) : &scenes[index];
+}
+
+namespace {
+
+// Bounds-checked access to a table inside the mapping
+template <typename T>
+const T* tableAt(const MappedFile& file, std::uint32_t offset, std::uint32_t count) {
+    if (offset % alignof(T) != 0 ||
+        static_cast<std::uint64_t>(offset) + static_cast<std::uint64_t>(count) * sizeof(T) > file.size()) {
+        return nullptr;
+    }
+    return reinterpret_cast<const T*>(file.data() + offset);
+}
+
+} // namespace
+
+std::optional<GameScript> ScriptParser::loadCompiledScript(const std::string& path) {
+    using namespace ScriptFormat;
+    
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+        std::cerr << "Failed to map compiled script: " << path << std::endl;
+        return std::nullopt;
+    }
+    
+    const ScriptHeader* header = tableAt<ScriptHeader>(*file, 0, 1);
+    if (!header || std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion) {
+        std::cerr << "Compiled script has wrong format or version: " << path << std::endl;
+        return std::nullopt;
+    }
+    
+    const SceneRecord* sceneTable = tableAt<SceneRecord>(*file, header->sceneTableOffset, header->sceneCount);
+    const ChoiceRecord* choiceTable = tableAt<ChoiceRecord>(*file, header->choiceTableOffset, header->choiceCount);
+    const EffectRecord* effectTable = tableAt<EffectRecord>(*file, header->effectTableOffset, header->effectCount);
+    const StrRef* unlockTable = tableAt<StrRef>(*file, header->unlockTableOffset, header->unlockCount);
+    const char* pool = reinterpret_cast<const char*>(file->data()) + header->stringPoolOffset;
+    if (!sceneTable || !choiceTable || !effectTable || !unlockTable ||
+        static_cast<std::uint64_t>(header->stringPoolOffset) + header->stringPoolSize > file->size()) {
+        std::cerr << "Compiled script is truncated: " << path << std::endl;
+        return std::nullopt;
+    }
+    
+    // Resolve a pool reference; any out-of-range reference invalidates the whole file
+    bool corrupt = false;
+    auto str = [&](const StrRef& ref) -> std::string_view {
+        if (static_cast<std::uint64_t>(ref.offset) + ref.length > header->stringPoolSize) {
+            corrupt = true;
+            return {};
         }
+        return std::string_view(pool + ref.offset, ref.length);
+    };
+    
+    GameScript script;
+    script.storage = file;
+    script.scriptId = std::string(str(header->scriptId));
+    script.title = std::string(str(header->title));
+    script.metadata.chapter = header->chapter;
+    script.metadata.estimatedTime = std::string(str(header->estimatedTime));
+    for (std::uint32_t i = 0; i < header->unlockCount; ++i) {
+        script.metadata.unlocks.emplace_back(str(unlockTable[i]));
     }
-    return nullptr;
-}
\ No newline at end of file
+    
+    script.scenes.reserve(header->sceneCount);
+    for (std::uint32_t i = 0; i < header->sceneCount; ++i) {
+        const SceneRecord& rec = sceneTable[i];
+        if (static_cast<std::uint64_t>(rec.firstChoice) + rec.choiceCount > header->choiceCount ||
+            static_cast<std::uint64_t>(rec.firstEffect) + rec.effectCount > header->effectCount) {
+            corrupt = true;
+            break;
+        }
+        
+        Scene scene;
+        scene.id = str(rec.id);
+        scene.symbol = intern(scene.id);
+        scene.background = internOptional(str(rec.background));
+        scene.text = str(rec.text);
+        scene.speaker = str(rec.speaker);
+        scene.speakerColor = str(rec.speakerColor);
+        
+        scene.choices.reserve(rec.choiceCount);
+        for (std::uint32_t c = 0; c < rec.choiceCount; ++c) {
+            const ChoiceRecord& choiceRec = choiceTable[rec.firstChoice + c];
+            Choice choice;
+            choice.text = str(choiceRec.text);
+            choice.nextScene = str(choiceRec.nextScene);
+            choice.nextScript = str(choiceRec.nextScript);
+            if (choiceRec.flags & ChoiceHasCondition) {
+                Condition cond;
+                cond.flag = internOptional(str(choiceRec.conditionFlag));
+                cond.flagsNot = internOptional(str(choiceRec.conditionFlagsNot));
+                cond.expression = str(choiceRec.conditionExpr);
+                std::string error;
+                if (!cond.compile(error)) {
+                    std::cerr << "Invalid condition in compiled script " << path << ": " << error << std::endl;
+                    return std::nullopt;
+                }
+                choice.condition = cond;
+            }
+            scene.choices.push_back(choice);
+        }
+        
+        if (rec.flags & SceneHasEffects) {
+            Effects eff;
+            for (std::uint32_t e = 0; e < rec.effectCount; ++e) {
+                const EffectRecord& effectRec = effectTable[rec.firstEffect + e];
+                Symbol name = internOptional(str(effectRec.name));
+                switch (effectRec.op) {
+                    case EffectOp::AddFlag:    eff.add(EffectStep::Op::SetFlag, name); break;
+                    case EffectOp::RemoveFlag: eff.add(EffectStep::Op::ClearFlag, name); break;
+                    case EffectOp::ModifyStat: eff.add(EffectStep::Op::AddStat, name, effectRec.amount); break;
+                    case EffectOp::AddItem:    eff.add(EffectStep::Op::AddItem, name, effectRec.amount); break;
+                    case EffectOp::RemoveItem: eff.add(EffectStep::Op::RemoveItem, name, effectRec.amount); break;
+                    default: corrupt = true; break;
+                }
+            }
+            eff.sort();
+            scene.effects = std::move(eff);
+        }
+        
+        script.scenes.push_back(std::move(scene));
+    }
+    
+    if (corrupt) {
+        std::cerr << "Compiled script is corrupt: " << path << std::endl;
+        return std::nullopt;
+    }
+    
+    link(script);
+    return script;
+}
+
+size_t SceneIndex::slotFor(Symbol key, unsigned shift) {
+    // Fibonacci hashing: the top log2(capacity) bits of the product spread the dense symbol
+    // ids over the table
+    return static_cast<size_t>(static_cast<std::uint32_t>(key * 2654435769u) >> shift);
+}
+
+void SceneIndex::build(const std::vector<Scene>& scenes) {
+    std::vector<Symbol> sceneIds;
+    sceneIds.reserve(scenes.size());
+    for (const auto& scene : scenes) {
+        sceneIds.push_back(scene.symbol);
+    }
+    build(sceneIds);
+}
+
+void SceneIndex::build(const std::vector<Symbol>& sceneIds) {
+    size_t capacity = 16;
+    shift = 28;
+    while (capacity < sceneIds.size() * 2) {
+        capacity *= 2;
+        --shift;
+    }
+    slots.assign(capacity, Slot{});
+    
+    const size_t mask = capacity - 1;
+    for (size_t i = 0; i < sceneIds.size(); ++i) {
+        Symbol key = sceneIds[i];
+        
+        // Linear probing until a free slot (or an earlier scene with the same id)
+        for (size_t pos = slotFor(key, shift);; pos = (pos + 1) & mask) {
+            Slot& slot = slots[pos];
+            if (slot.key == NO_SYMBOL) {
+                slot.key = key;
+                slot.scene = static_cast<std::uint32_t>(i);
+                break;
+            }
+            if (slot.key == key) {
+                std::cerr << "Duplicate scene id: " << symbolName(key) << std::endl;
+                break;
+            }
+        }
+    }
+}
+
+std::uint32_t SceneIndex::find(Symbol sceneId) const {
+    if (slots.empty() || sceneId == NO_SYMBOL) {
+        return SCENE_NONE;
+    }
+    
+    const size_t mask = slots.size() - 1;
+    for (size_t pos = slotFor(sceneId, shift);; pos = (pos + 1) & mask) {
+        const Slot& slot = slots[pos];
+        if (slot.key == sceneId) {
+            return slot.scene;
+        }
+        if (slot.key == NO_SYMBOL) {
+            return SCENE_NONE;
+        }
+    }
+}
+
+bool ScriptParser::link(GameScript& script) {
+    script.index.build(script.scenes);
+    
+    bool allResolved = true;
+    for (auto& scene : script.scenes) {
+        allResolved = resolveTargets(script, scene) && allResolved;
+    }
+    return allResolved;
+}
+
+const Scene* ScriptParser::findScene(const GameScript& script, std::string_view sceneId) {
+    std::uint32_t index = findSceneIndex(script, sceneId);
+    return index == SCENE_NONE ? nullptr : script.scene(index);
+}
+
+std::uint32_t ScriptParser::findSceneIndex(const GameScript& script, std::string_view sceneId) {
+    return script.index.find(SymbolTable::global().find(sceneId));
+}
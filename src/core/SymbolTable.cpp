@@ -0,0 +1,45 @@
+#include "SymbolTable.h"
+#include <mutex>
+
+SymbolTable& SymbolTable::global() {
+    static SymbolTable table;
+    return table;
+}
+
+Symbol SymbolTable::intern(std::string_view name) {
+    {
+        std::shared_lock lock(mutex);
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+    }
+    
+    std::unique_lock lock(mutex);
+    // Another thread may have added it between the two locks
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    
+    Symbol id = static_cast<Symbol>(names.size());
+    names.emplace_back(name);
+    ids.emplace(names.back(), id);
+    return id;
+}
+
+Symbol SymbolTable::find(std::string_view name) const {
+    std::shared_lock lock(mutex);
+    auto it = ids.find(name);
+    return it != ids.end() ? it->second : NO_SYMBOL;
+}
+
+std::string_view SymbolTable::name(Symbol id) const {
+    std::shared_lock lock(mutex);
+    return id < names.size() ? std::string_view(names[id]) : std::string_view();
+}
+
+size_t SymbolTable::size() const {
+    std::shared_lock lock(mutex);
+    return names.size();
+}
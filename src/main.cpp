@@ -1,9 +1,26 @@
 // SFML 3.x, 2.x is retarded so dont use it and
 
 #include "GameEngine.h"
+#include <cstring>
 
-int main() {
-    GameEngine engine;
+int main(int argc, char* argv[]) {
+    // --startup-timings prints how long each startup asset took to load
+    // --decoded-cache keeps decoded images in cache/decoded so warm starts skip decoding
+    // --journal-saves appends each transition's changes to a journal instead of rewriting the save
+    bool reportStartup = false;
+    bool decodedCache = false;
+    bool journalSaves = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--startup-timings") == 0) {
+            reportStartup = true;
+        } else if (std::strcmp(argv[i], "--decoded-cache") == 0) {
+            decodedCache = true;
+        } else if (std::strcmp(argv[i], "--journal-saves") == 0) {
+            journalSaves = true;
+        }
+    }
+    
+    GameEngine engine(reportStartup, decodedCache, journalSaves);
     
     // Start with main menu - callbacks handled by engine
     engine.pushState(engine.createMainMenuState());
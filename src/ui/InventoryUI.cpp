@@ -2,6 +2,16 @@
 #include "InventorySystem.h"
 #include <cmath>
 
+namespace {
+
+const sf::Color CELL_COLOR(50, 50, 60, 180);
+const sf::Color CELL_HOVER_COLOR(70, 70, 80, 200);
+const sf::Color CELL_OUTLINE_COLOR(80, 80, 90);
+constexpr float CELL_OUTLINE = 1.f;
+constexpr float ITEM_PADDING = 4.f;
+
+} // namespace
+
 InventoryUI::InventoryUI(ResourceManager& resources)
     : resources(resources),
       tooltipTitle(resources.getFont("main"), "", 18),
@@ -52,12 +62,6 @@ void InventoryUI::createGrid(const sf::FloatRect& bounds, float padding) {
             float y = startY + row * (cellSide + cellPadding);
             
             cell.bounds = sf::FloatRect({x, y}, {cellSide, cellSide});
-            cell.background.setSize({cellSide, cellSide});
-            cell.background.setPosition({x, y});
-            cell.background.setFillColor(sf::Color(50, 50, 60, 180));
-            cell.background.setOutlineColor(sf::Color(80, 80, 90));
-            cell.background.setOutlineThickness(1.f);
-            
             grid.push_back(cell);
         }
     }
@@ -179,77 +183,80 @@ void InventoryUI::update(const sf::Vector2i& mousePos, const InventorySystem& in
     scrollOffset = std::clamp(scrollOffset, 0, maxScroll);
 }
 
-// Render grid cells, item sprites, and tooltip
+// Two triangles covering bounds, sampling the given texture rect
+void InventoryUI::appendQuad(const sf::FloatRect& bounds, const sf::FloatRect& texture, sf::Color color) {
+    const sf::Vector2f corners[4] = {
+        bounds.position,
+        {bounds.position.x + bounds.size.x, bounds.position.y},
+        bounds.position + bounds.size,
+        {bounds.position.x, bounds.position.y + bounds.size.y}
+    };
+    const sf::Vector2f texCoords[4] = {
+        texture.position,
+        {texture.position.x + texture.size.x, texture.position.y},
+        texture.position + texture.size,
+        {texture.position.x, texture.position.y + texture.size.y}
+    };
+    for (int corner : {0, 1, 2, 0, 2, 3}) {
+        gridVertices.append(sf::Vertex{corners[corner], color, texCoords[corner]});
+    }
+}
+
+// Render grid cells and item icons as one vertex array, then the tooltip
 void InventoryUI::draw(sf::RenderWindow& window, const InventorySystem& inventory) {
     const auto& items = inventory.getItems();
+    const ItemRegistry& registry = inventory.getRegistry();
+    const IconAtlas& atlas = registry.getIconAtlas();
+    
+    // Cell backgrounds sample the atlas' white block, so they share the icons' texture
+    const sf::FloatRect white(atlas.getWhiteTexel(), {0.f, 0.f});
     
+    gridVertices.clear();
     for (size_t i = 0; i < grid.size(); ++i) {
-        auto& cell = grid[i];
+        const sf::FloatRect& bounds = grid[i].bounds;
         int itemIndex = (scrollOffset * columns) + static_cast<int>(i);
+        bool occupied = itemIndex < static_cast<int>(items.size());
+        
+        // Outline drawn outside the cell, as sf::RectangleShape did
+        const float side = CELL_OUTLINE;
+        const sf::Vector2f outer = bounds.position - sf::Vector2f(side, side);
+        const sf::Vector2f outerSize = bounds.size + sf::Vector2f(side * 2, side * 2);
+        appendQuad({outer, {outerSize.x, side}}, white, CELL_OUTLINE_COLOR);
+        appendQuad({{outer.x, bounds.position.y + bounds.size.y}, {outerSize.x, side}}, white, CELL_OUTLINE_COLOR);
+        appendQuad({{outer.x, bounds.position.y}, {side, bounds.size.y}}, white, CELL_OUTLINE_COLOR);
+        appendQuad({{bounds.position.x + bounds.size.x, bounds.position.y}, {side, bounds.size.y}}, white, CELL_OUTLINE_COLOR);
         
         // Highlight hovered cell
-        if (static_cast<int>(i) == hoveredCell && itemIndex < static_cast<int>(items.size())) {
-            cell.background.setFillColor(sf::Color(70, 70, 80, 200));
-        } else {
-            cell.background.setFillColor(sf::Color(50, 50, 60, 180));
+        bool hovered = static_cast<int>(i) == hoveredCell && occupied;
+        appendQuad(bounds, white, hovered ? CELL_HOVER_COLOR : CELL_COLOR);
+        
+        if (!occupied) {
+            continue;
+        }
+        const sf::IntRect* icon = registry.getIcon(items[itemIndex].id);
+        if (!icon) {
+            continue;
         }
         
-        window.draw(cell.background);
+        // Scale icon to fit cell with padding, centred
+        float maxSize = cellSize.x - ITEM_PADDING * 2;
+        sf::Vector2f iconSize(icon->size);
+        float scale = maxSize / std::max(iconSize.x, iconSize.y);
+        sf::Vector2f drawSize = iconSize * scale;
+        sf::Vector2f position(bounds.position.x + (cellSize.x - drawSize.x) / 2.f,
+                              bounds.position.y + (cellSize.y - drawSize.y) / 2.f);
+        appendQuad({position, drawSize}, sf::FloatRect(sf::Vector2f(icon->position), iconSize), sf::Color::White);
         
-        // Draw item sprite if cell has an item
-        if (itemIndex < static_cast<int>(items.size())) {
-            const auto& item = items[itemIndex];
-            const ItemDefinition* def = inventory.getItemDefinition(item.id);
-            
-            if (def) {
-                try {
-                    const sf::Texture& texture = resources.getTexture(item.id);
-                    sf::Sprite sprite(texture);
-                    
-                    // Scale sprite to fit cell with padding
-                    float itemPadding = 4.f;
-                    float maxSize = cellSize.x - itemPadding * 2;
-                    sf::Vector2u texSize = texture.getSize();
-                    float scale = maxSize / std::max(static_cast<float>(texSize.x), 
-                                                    static_cast<float>(texSize.y));
-                    sprite.setScale({scale, scale});
-                    
-                    // Center sprite in cell
-                    sf::FloatRect spriteBounds = sprite.getGlobalBounds();
-                    sprite.setPosition({
-                        cell.bounds.position.x + (cellSize.x - spriteBounds.size.x) / 2.f,
-                        cell.bounds.position.y + (cellSize.y - spriteBounds.size.y) / 2.f
-                    });
-                    
-                    window.draw(sprite);
-                    
-                    // Quantity text temporarily disabled to fix duplication bug
-                    
-                    // if (item.quantity > 1) {
-                    //     sf::Text quantityText(resources.getFont("main"), 
-                    //                         std::to_string(item.quantity),
-                    //                         static_cast<unsigned int>(14 * currentScale));
-                    //     quantityText.setFillColor(sf::Color::White);
-                        
-                    //     sf::FloatRect textBounds = quantityText.getGlobalBounds();
-                    //     quantityText.setPosition({
-                    //         cell.bounds.position.x + cellSize.x - textBounds.size.x - 4.f,
-                    //         cell.bounds.position.y + cellSize.y - textBounds.size.y - 4.f
-                    //     });
-                        
-                    //     window.draw(quantityText);
-                    // }
-                } catch (...) {
-                    // Texture not loaded, skip drawing
-                }
-            }
-        }
+        // Quantity text temporarily disabled to fix duplication bug
     }
     
+    // Until the first icon is uploaded there is no texture; the cells are plain vertex colours
+    window.draw(gridVertices, sf::RenderStates(atlas.getTexture()));
+    
     // Draw tooltip on top of everything
     if (showTooltip) {
         window.draw(tooltipBackground);
         window.draw(tooltipTitle);
         window.draw(tooltipDescription);
     }
-}
\ No newline at end of file
+}
@@ -1,6 +1,43 @@
 // SFML 3.x
 
 #include "MainMenuState.h"
+#include "SaveSlots.h"
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+namespace {
+
+const unsigned int SLOT_TEXT_SIZE = 20;
+const float SLOT_SPACING = 34.f;
+const float SLOT_MARGIN = 40.f;
+
+// "Slot 1 - Title, Chapter 2 - scene_id - 1:02:03 - 2026-01-31 18:05"
+std::string describeSlot(int slot, const SlotInfo& info) {
+    std::string label = "Slot " + std::to_string(slot + 1) + " - ";
+    if (!info.used) {
+        return label + "Empty";
+    }
+    if (info.scriptTitle.empty()) {
+        return label + "Saved game";
+    }
+    label += info.scriptTitle + ", Chapter " + std::to_string(info.chapter) + " - " + info.sceneId;
+    
+    char buffer[64];
+    std::uint32_t seconds = info.playtimeSeconds;
+    std::snprintf(buffer, sizeof(buffer), " - %u:%02u:%02u", seconds / 3600, seconds / 60 % 60, seconds % 60);
+    label += buffer;
+    
+    std::time_t savedAt = static_cast<std::time_t>(info.savedAt);
+    if (const std::tm* local = std::localtime(&savedAt)) {
+        if (std::strftime(buffer, sizeof(buffer), " - %Y-%m-%d %H:%M", local) > 0) {
+            label += buffer;
+        }
+    }
+    return label;
+}
+
+} // namespace
 
 MainMenuState::MainMenuState(ResourceManager& resources)
     : resources(resources),
@@ -17,6 +54,25 @@ MainMenuState::MainMenuState(ResourceManager& resources)
     settingsButton = std::make_unique<Button>(resources, &resources.getTexture("settings"), sf::Vector2f(0, 0));
     settingsButton->setScale({0.8f, 0.8f});
     
+    // Listed from the save index only; no save is opened until one is started. The most
+    // recently saved slot starts out selected.
+    std::int64_t newest = 0;
+    for (int slot = 0; slot < SaveSlots::SLOT_COUNT; ++slot) {
+        SlotInfo info = SaveSlots::global().getSlot(slot);
+        if (info.used && info.savedAt > newest) {
+            newest = info.savedAt;
+            selectedSlot = slot;
+        }
+        
+        auto button = std::make_unique<Button>(resources, nullptr, sf::Vector2f(0, 0));
+        button->setOnClick([this, slot]() {
+            selectedSlot = slot;
+            refreshSlots();
+        });
+        slotButtons.push_back(std::move(button));
+    }
+    refreshSlots();
+    
     // Initialize transition overlay
     transitionOverlay.setFillColor(sf::Color(0, 0, 0, 0));
 }
@@ -41,13 +97,27 @@ void MainMenuState::updatePositions(const sf::Vector2u& windowSize)
     startButton->setPosition({windowSize.x / 2.f, windowSize.y / 3.f + 125.f});
     settingsButton->setPosition({windowSize.x / 2.f, windowSize.y / 3.f + 250.f});
     
+    // Slot list in the bottom-left corner
+    for (std::size_t i = 0; i < slotButtons.size(); ++i) {
+        float rowsBelow = static_cast<float>(slotButtons.size() - i);
+        slotButtons[i]->setPosition({SLOT_MARGIN, windowSize.y - SLOT_MARGIN - rowsBelow * SLOT_SPACING});
+    }
+    
     // Update transition overlay size
     transitionOverlay.setSize(sf::Vector2f(static_cast<float>(windowSize.x), 
                                            static_cast<float>(windowSize.y)));
     transitionOverlay.setPosition({0.f, 0.f});
 }
 
-void MainMenuState::setOnStartClicked(std::function<void()> callback)
+void MainMenuState::refreshSlots()
+{
+    for (int slot = 0; slot < static_cast<int>(slotButtons.size()); ++slot) {
+        std::string label = describeSlot(slot, SaveSlots::global().getSlot(slot));
+        slotButtons[slot]->setText((slot == selectedSlot ? "> " : "  ") + label, resources.getFont("main"), SLOT_TEXT_SIZE);
+    }
+}
+
+void MainMenuState::setOnStartClicked(std::function<void(int saveSlot)> callback)
 {
     onStartClicked = callback;
     startButton->setOnClick([this, callback]() {
@@ -73,6 +143,9 @@ void MainMenuState::handleEvent(const sf::Event& event)
     
     startButton->handleEvent(event);
     settingsButton->handleEvent(event);
+    for (auto& button : slotButtons) {
+        button->handleEvent(event);
+    }
 }
 
 void MainMenuState::update(float deltaTime, sf::RenderWindow& window)
@@ -87,7 +160,7 @@ void MainMenuState::update(float deltaTime, sf::RenderWindow& window)
             
             // Trigger the actual state change
             if (onStartClicked) {
-                onStartClicked();
+                onStartClicked(selectedSlot);
             }
         }
         
@@ -106,6 +179,9 @@ void MainMenuState::update(float deltaTime, sf::RenderWindow& window)
         auto mousePos = sf::Mouse::getPosition(window);
         startButton->update(mousePos);
         settingsButton->update(mousePos);
+        for (auto& button : slotButtons) {
+            button->update(mousePos);
+        }
     }
 }
 
@@ -116,6 +192,9 @@ void MainMenuState::draw(sf::RenderWindow& window)
     window.draw(titleSprite);
     startButton->draw(window);
     settingsButton->draw(window);
+    for (auto& button : slotButtons) {
+        button->draw(window);
+    }
     
     // Draw transition overlay on top of everything
     if (isTransitioning) {
@@ -124,6 +203,7 @@ void MainMenuState::draw(sf::RenderWindow& window)
 }
 
 void MainMenuState::resetTransition() {
+    refreshSlots();
     isTransitioning = false;
     transitionAlpha = 0.f;
     transitionOverlay.setFillColor(sf::Color(0, 0, 0, 0));
@@ -79,11 +79,11 @@ void PlayingStateUI::updatePositions(const sf::Vector2u& newWindowSize, const Sc
     // Update dialog text if scene exists
     if (currentScene) {
         float maxTextWidth = metrics.dialogBoxSize.x - (metrics.scale.boxPadding * 2);
-        std::string wrappedText = DialogBox::wrapText(currentScene->text, 
+        std::string wrappedText = DialogBox::wrapText(std::string(currentScene->text), 
                                                       static_cast<unsigned int>(maxTextWidth), 
                                                       resources.getFont("main"), 
                                                       dialogSize);
-        dialogBox->setText(wrappedText, currentScene->speaker, currentScene->speakerColor);
+        dialogBox->setText(wrappedText, std::string(currentScene->speaker), std::string(currentScene->speakerColor));
         dialogBox->updateLayout(dialogBounds, metrics.scale.boxPadding, 
                                metrics.scale.scaleY, dialogSize, speakerSize);
     }
@@ -191,7 +191,7 @@ void PlayingStateUI::updateChoicePositions(const std::vector<std::unique_ptr<But
             currentSize -= 1;
             
             float maxTextWidth = metrics.dialogBoxSize.x - (metrics.scale.boxPadding * 2);
-            std::string wrappedText = DialogBox::wrapText(currentScene->text, 
+            std::string wrappedText = DialogBox::wrapText(std::string(currentScene->text), 
                                                          static_cast<unsigned int>(maxTextWidth), 
                                                          resources.getFont("main"), 
                                                          currentSize);
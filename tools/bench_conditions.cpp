@@ -0,0 +1,127 @@
+// Condition expression benchmark: walking the parsed tree vs running the compiled bytecode
+//
+// Generates random expressions over flags, stats and item counts (comparisons joined by
+// and/or/not, a few levels deep), then times evaluating every one of them both ways
+// against the same state and makes sure both agree on every result.
+//
+// Usage: bench_conditions [expressions]
+
+#include "ConditionExpr.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kNameCount = 64;
+
+// Game state indexed by symbol; names that were never given a value read as 0
+struct BenchState {
+    std::vector<char> flags;
+    std::vector<int> stats;
+    std::vector<int> itemCounts;
+
+    bool flag(Symbol name) const { return name < flags.size() && flags[name]; }
+    int stat(Symbol name) const { return name < stats.size() ? stats[name] : 0; }
+    int items(Symbol name) const { return name < itemCounts.size() ? itemCounts[name] : 0; }
+};
+
+std::string randomName(std::mt19937& rng) {
+    return "bench_" + std::to_string(rng() % kNameCount);
+}
+
+std::string randomComparison(std::mt19937& rng) {
+    static const char* operators[] = {"==", "!=", "<", "<=", ">", ">="};
+    switch (rng() % 4) {
+        case 0: return randomName(rng);
+        case 1: return "flag(" + randomName(rng) + ")";
+        case 2: return "stat(" + randomName(rng) + ") " + operators[rng() % 6] + " " + std::to_string(static_cast<int>(rng() % 11) - 5);
+        default: return "items(" + randomName(rng) + ") " + operators[rng() % 6] + " " + std::to_string(rng() % 4);
+    }
+}
+
+std::string randomExpression(std::mt19937& rng, int depth) {
+    if (depth == 0 || rng() % 3 == 0) {
+        return randomComparison(rng);
+    }
+    std::string left = randomExpression(rng, depth - 1);
+    std::string right = randomExpression(rng, depth - 1);
+    std::string joined = "(" + left + (rng() % 2 ? " && " : " || ") + right + ")";
+    return rng() % 5 == 0 ? "!" + joined : joined;
+}
+
+template <typename Evaluate>
+double nanosecondsPerCheck(std::size_t count, int rounds, std::vector<char>& results, Evaluate evaluate) {
+    auto start = Clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (std::size_t i = 0; i < count; ++i) {
+            results[i] = evaluate(i);
+        }
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (count * rounds);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int expressionCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20000;
+    constexpr int kRounds = 10;
+
+    std::mt19937 rng(42);
+    BenchState state;
+    for (int i = 0; i < kNameCount; ++i) {
+        Symbol name = intern("bench_" + std::to_string(i));
+        if (name >= state.flags.size()) {
+            state.flags.resize(name + 1, 0);
+            state.stats.resize(name + 1, 0);
+            state.itemCounts.resize(name + 1, 0);
+        }
+        state.flags[name] = rng() % 2;
+        state.stats[name] = static_cast<int>(rng() % 11) - 5;
+        state.itemCounts[name] = static_cast<int>(rng() % 4);
+    }
+
+    std::vector<std::unique_ptr<ExprNode>> trees;
+    std::vector<ConditionProgram> programs(expressionCount);
+    std::size_t instructions = 0;
+    for (int i = 0; i < expressionCount; ++i) {
+        std::string source = randomExpression(rng, 4);
+        std::string error;
+        trees.push_back(parseCondition(source, error));
+        if (!trees.back() || !ConditionProgram::compile(*trees.back(), programs[i], error)) {
+            std::cerr << "Failed to compile generated expression: " << error << std::endl;
+            return 1;
+        }
+        instructions += programs[i].getCode().size();
+    }
+
+    std::vector<char> walked(expressionCount);
+    std::vector<char> compiled(expressionCount);
+    double treeNs = nanosecondsPerCheck(trees.size(), kRounds, walked,
+                                        [&](std::size_t i) { return evaluateTree(*trees[i], state) != 0; });
+    double programNs = nanosecondsPerCheck(programs.size(), kRounds, compiled,
+                                           [&](std::size_t i) { return programs[i].run(state); });
+    if (walked != compiled) {
+        std::cerr << "Tree and bytecode disagree on an expression" << std::endl;
+        return 1;
+    }
+
+    long long passed = std::count(compiled.begin(), compiled.end(), 1);
+    std::cout << expressionCount << " expressions, " << std::fixed << std::setprecision(1)
+              << static_cast<double>(instructions) / expressionCount << " instructions each ("
+              << passed << " pass)" << std::endl;
+    auto print = [](const char* name, double ns) {
+        std::cout << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << ns << " ns/check" << std::endl;
+    };
+    print("tree", treeNs);
+    print("bytecode", programNs);
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Flag benchmark: the old hash-map flag lookups (with and without their logging) vs the
+// bitset FlagSet testing compiled conditions
+//
+// Sets 10k flags, builds conditions over them shaped like the scripts' (a required flag,
+// a forbidden one, or both), then times checking all of them against each store and makes
+// sure every store agrees on every result.
+//
+// Usage: bench_flags [checks]
+
+#include "FlagSet.h"
+#include "ScriptParser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kFlagCount = 10000;
+
+// Discards everything, so the logging row measures formatting rather than the terminal
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+// What GameStateManager::checkCondition did before FlagSet: up to two hash lookups, each
+// optionally logged the way the old code logged them
+bool checkMap(const std::unordered_map<Symbol, bool>& flags, const Condition& condition, std::ostream* log) {
+    if (log) {
+        *log << "Checking condition - flag: '" << symbolName(condition.flag)
+             << "', flagsNot: '" << symbolName(condition.flagsNot) << "'" << std::endl;
+    }
+    if (condition.flag != NO_SYMBOL) {
+        auto it = flags.find(condition.flag);
+        if (log) {
+            *log << "  Flag '" << symbolName(condition.flag) << "' exists: " << (it != flags.end())
+                 << ", value: " << (it != flags.end() && it->second) << ", required: " << condition.requiredValue << std::endl;
+        }
+        if (it == flags.end()) {
+            return !condition.requiredValue;
+        }
+        if (it->second != condition.requiredValue) {
+            return false;
+        }
+    }
+    if (condition.flagsNot != NO_SYMBOL) {
+        auto it = flags.find(condition.flagsNot);
+        if (it != flags.end() && it->second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Check>
+double nanosecondsPerCheck(const std::vector<Condition>& conditions, std::vector<char>& results, Check check) {
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < conditions.size(); ++i) {
+        results[i] = check(conditions[i]);
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / conditions.size();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int checkCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+
+    // Every other flag set, a third of those false; the rest never set (read as false)
+    std::mt19937 rng(42);
+    std::vector<Symbol> names;
+    std::unordered_map<Symbol, bool> map;
+    FlagSet bits;
+    for (int i = 0; i < kFlagCount; ++i) {
+        names.push_back(intern("bench_flag_" + std::to_string(i)));
+        if (i % 2 == 0) {
+            bool value = i % 3 != 0;
+            map[names.back()] = value;
+            bits.set(names.back(), value);
+        }
+    }
+
+    std::vector<Condition> conditions(checkCount);
+    for (Condition& condition : conditions) {
+        int shape = static_cast<int>(rng() % 3);
+        if (shape != 1) condition.flag = names[rng() % names.size()];
+        if (shape != 0) condition.flagsNot = names[rng() % names.size()];
+        std::string error;
+        condition.compile(error);
+    }
+
+    NullBuffer nullBuffer;
+    std::ostream nullLog(&nullBuffer);
+    std::vector<char> logged(conditions.size());
+    std::vector<char> hashed(conditions.size());
+    std::vector<char> compiled(conditions.size());
+    double loggedNs = nanosecondsPerCheck(conditions, logged, [&](const Condition& c) { return checkMap(map, c, &nullLog); });
+    double hashedNs = nanosecondsPerCheck(conditions, hashed, [&](const Condition& c) { return checkMap(map, c, nullptr); });
+    double compiledNs = nanosecondsPerCheck(conditions, compiled, [&](const Condition& c) { return bits.matches(c.compiled); });
+    if (logged != hashed || hashed != compiled) {
+        std::cerr << "Flag stores disagree on a condition" << std::endl;
+        return 1;
+    }
+
+    long long passed = std::count(compiled.begin(), compiled.end(), 1);
+    std::cout << kFlagCount << " flags, " << checkCount << " checks (" << passed << " pass)" << std::endl;
+    auto print = [](const char* name, double ns) {
+        std::cout << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << ns << " ns/check" << std::endl;
+    };
+    print("map + logging", loggedNs);
+    print("map", hashedNs);
+    print("bitset", compiledNs);
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Decoded image cache benchmark: cold decode vs warm cache load for a directory of images
+//
+// For every .jpeg/.jpg/.png in the directory: decode it with sf::Image (cold), write the
+// decoded pixels to a scratch cache, then load them back from the cache (warm) and check
+// the pixels match. With --fit the images are also downscaled to fit the given size, as
+// the game does for backgrounds, and the cached variant is the downscaled one.
+//
+// Usage: bench_image_cache [image-dir] [--runs N] [--fit WxH]
+
+#include "AssetManifest.h"
+#include "DecodedImageCache.h"
+#include "ImageScaling.h"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct Totals {
+    double coldMs = 0.0;   // Decode (+ downscale)
+    double storeMs = 0.0;  // Writing the cache entries
+    double warmMs = 0.0;   // Cache hit into an sf::Image
+    double mappedMs = 0.0; // Cache hit, pixels used in place (what the texture upload path does)
+};
+
+// Decode and optionally downscale, like ResourceManager does on a cache miss
+bool decode(const std::string& path, ImageScaling::Size fit, sf::Image& image) {
+    if (!image.loadFromFile(path)) {
+        return false;
+    }
+    ImageScaling::Size size{image.getSize().x, image.getSize().y};
+    ImageScaling::Size target = ImageScaling::fitWithin(size, fit);
+    if (target.width != size.width || target.height != size.height) {
+        std::vector<std::uint8_t> pixels = ImageScaling::downscaleBox(image.getPixelsPtr(), size, target);
+        image = sf::Image({target.width, target.height}, pixels.data());
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string directory = "assets/images";
+    int runs = 3;
+    ImageScaling::Size fit;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--fit") == 0 && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%ux%u", &fit.width, &fit.height) != 2) {
+                std::cerr << "--fit expects WxH" << std::endl;
+                return 1;
+            }
+        } else {
+            directory = argv[i];
+        }
+    }
+
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        AssetFormat format = AssetManifest::formatForExtension(entry.path().extension().string());
+        if (entry.is_regular_file() && (format == AssetFormat::Jpeg || format == AssetFormat::Png)) {
+            paths.push_back(entry.path().generic_string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    if (ec || paths.empty()) {
+        std::cerr << "No images found in " << directory << std::endl;
+        return 1;
+    }
+
+    fs::path cacheDirectory = fs::temp_directory_path() / "uag_bench_image_cache";
+    DecodedImageCache cache(cacheDirectory.string());
+
+    std::vector<Totals> results;
+    for (int run = 0; run < runs; ++run) {
+        fs::remove_all(cacheDirectory, ec);
+        Totals totals;
+
+        for (const auto& path : paths) {
+            DecodedImageCache::Source source = DecodedImageCache::describeFile(path);
+
+            auto start = Clock::now();
+            sf::Image decoded;
+            if (!decode(path, fit, decoded)) {
+                std::cerr << "Failed to decode " << path << std::endl;
+                return 1;
+            }
+            totals.coldMs += millisecondsSince(start);
+
+            start = Clock::now();
+            cache.store(source, fit, decoded.getPixelsPtr(), {decoded.getSize().x, decoded.getSize().y});
+            totals.storeMs += millisecondsSince(start);
+
+            start = Clock::now();
+            auto entry = cache.load(source, fit);
+            if (!entry) {
+                std::cerr << "Cache miss after store: " << path << std::endl;
+                return 1;
+            }
+            sf::Image warm({entry->width(), entry->height()}, entry->pixels());
+            totals.warmMs += millisecondsSince(start);
+
+            start = Clock::now();
+            auto mapped = cache.load(source, fit);
+            // Touch one byte per page, as an upload reading the mapping would
+            std::size_t bytes = static_cast<std::size_t>(mapped->width()) * mapped->height() * 4;
+            volatile std::uint8_t sink = 0;
+            for (std::size_t offset = 0; offset < bytes; offset += 4096) {
+                sink = sink + mapped->pixels()[offset];
+            }
+            totals.mappedMs += millisecondsSince(start);
+
+            if (warm.getSize() != decoded.getSize() ||
+                std::memcmp(warm.getPixelsPtr(), decoded.getPixelsPtr(), bytes) != 0) {
+                std::cerr << "Cached pixels differ: " << path << std::endl;
+                return 1;
+            }
+        }
+        results.push_back(totals);
+    }
+
+    std::uintmax_t cacheBytes = 0;
+    for (const auto& entry : fs::directory_iterator(cacheDirectory, ec)) {
+        cacheBytes += entry.file_size();
+    }
+    fs::remove_all(cacheDirectory, ec);
+
+    // Best run of each, to keep one-off disk hiccups out of the comparison
+    auto best = [&results](double Totals::*field) {
+        double value = results.front().*field;
+        for (const auto& totals : results) {
+            value = std::min(value, totals.*field);
+        }
+        return value;
+    };
+    double cold = best(&Totals::coldMs);
+    double warm = best(&Totals::warmMs);
+    double mapped = best(&Totals::mappedMs);
+
+    std::cout << paths.size() << " images from " << directory;
+    if (fit.width > 0) {
+        std::cout << " fitted to " << fit.width << "x" << fit.height;
+    }
+    std::cout << ", best of " << runs << " runs, cache " << cacheBytes / (1024 * 1024) << " MiB on disk" << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << std::left << std::setw(28) << "cold decode" << std::right << std::setw(10) << cold << " ms" << std::endl
+              << std::left << std::setw(28) << "cache write" << std::right << std::setw(10) << best(&Totals::storeMs) << " ms" << std::endl
+              << std::left << std::setw(28) << "warm load (sf::Image)" << std::right << std::setw(10) << warm << " ms"
+              << "  (" << cold / warm << "x)" << std::endl
+              << std::left << std::setw(28) << "warm load (mapped)" << std::right << std::setw(10) << mapped << " ms"
+              << "  (" << cold / mapped << "x)" << std::endl;
+    return 0;
+}
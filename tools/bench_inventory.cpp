@@ -0,0 +1,140 @@
+// Inventory benchmark: linear stack scans (the old InventorySystem) vs the indexed ItemStacks
+//
+// Fills inventories with 100, 1k and 10k stacks spread over as many distinct items, then
+// times item counts, presence checks and top-up adds against each. The indexed queries
+// should stay flat as the inventory grows; the linear ones grow with it.
+//
+// Usage: bench_inventory [queries]
+
+#include "ItemStacks.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kMaxStackSize = 99;
+
+// What InventorySystem did before the index: every query walks all stacks
+class LinearStacks {
+public:
+    void add(Symbol id, int quantity) {
+        for (auto& stack : stacks) {
+            if (stack.id == id && stack.quantity < kMaxStackSize) {
+                int canAdd = std::min(quantity, kMaxStackSize - stack.quantity);
+                stack.quantity += canAdd;
+                quantity -= canAdd;
+                if (quantity <= 0) {
+                    return;
+                }
+            }
+        }
+        while (quantity > 0) {
+            int stackSize = std::min(quantity, kMaxStackSize);
+            stacks.emplace_back(id, stackSize);
+            quantity -= stackSize;
+        }
+    }
+
+    bool contains(Symbol id) const {
+        for (const auto& stack : stacks) {
+            if (stack.id == id) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int count(Symbol id) const {
+        int total = 0;
+        for (const auto& stack : stacks) {
+            if (stack.id == id) {
+                total += stack.quantity;
+            }
+        }
+        return total;
+    }
+
+private:
+    std::vector<InventoryItem> stacks;
+};
+
+struct Result {
+    double countNs = 0.0;
+    double containsNs = 0.0;
+    double addNs = 0.0;
+};
+
+// Nanoseconds per call of op over the query ids
+template <typename Op>
+double timePerCall(const std::vector<Symbol>& queries, Op op, long long& sink) {
+    auto start = Clock::now();
+    for (Symbol id : queries) {
+        sink += op(id);
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / queries.size();
+}
+
+template <typename Stacks, typename Add>
+Result run(const std::vector<Symbol>& items, const std::vector<Symbol>& queries, Add add, long long& sink) {
+    Stacks stacks;
+    for (Symbol id : items) {
+        add(stacks, id, 1);
+    }
+
+    Result result;
+    result.countNs = timePerCall(queries, [&](Symbol id) { return stacks.count(id); }, sink);
+    result.containsNs = timePerCall(queries, [&](Symbol id) { return stacks.contains(id) ? 1 : 0; }, sink);
+    // Last, since it grows the inventory: picking up one more of an item, topping up its stacks
+    result.addNs = timePerCall(queries, [&](Symbol id) { add(stacks, id, 1); return 0; }, sink);
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int queryCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+
+    std::cout << std::left << std::setw(8) << "stacks" << std::setw(12) << "impl" << std::right
+              << std::setw(14) << "count (ns)" << std::setw(16) << "contains (ns)" << std::setw(12) << "add (ns)" << std::endl;
+
+    long long sink = 0;
+    for (int stackCount : {100, 1000, 10000}) {
+        std::vector<Symbol> items;
+        for (int i = 0; i < stackCount; ++i) {
+            items.push_back(intern("bench_item_" + std::to_string(i)));
+        }
+
+        // Random held items, plus some that are not held at all
+        std::mt19937 rng(42);
+        std::vector<Symbol> queries;
+        for (int i = 0; i < queryCount; ++i) {
+            queries.push_back(i % 8 == 0 ? intern("bench_missing_" + std::to_string(i % 64)) : items[rng() % items.size()]);
+        }
+
+        Result linear = run<LinearStacks>(items, queries,
+                                          [](LinearStacks& stacks, Symbol id, int quantity) { stacks.add(id, quantity); }, sink);
+        Result indexed = run<ItemStacks>(items, queries,
+                                         [](ItemStacks& stacks, Symbol id, int quantity) {
+                                             stacks.add(id, quantity, kMaxStackSize, true);
+                                         }, sink);
+
+        auto print = [&](const char* name, const Result& result) {
+            std::cout << std::left << std::setw(8) << stackCount << std::setw(12) << name << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(14) << result.countNs << std::setw(16) << result.containsNs
+                      << std::setw(12) << result.addNs << std::endl;
+        };
+        print("linear", linear);
+        print("indexed", indexed);
+    }
+
+    // Keep the queries from being optimised away
+    return sink == -1 ? 1 : 0;
+}
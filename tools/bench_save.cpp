@@ -0,0 +1,269 @@
+// Save format benchmark: indented JSON text (the old save) vs the binary CBOR save
+//
+// Builds save states of two sizes (one shaped like a real playthrough, one with 10k flags),
+// then for each format times serializing and writing the file, reading it back into a
+// document, and streaming it through a SAX handler the way GameStateManager does. Reports
+// file size and the best time of several runs, and checks both formats load identically.
+// The journal row's bytes and save time are one transition appended in journal mode (a flag,
+// an item, a location), which costs the same whatever the size of the state. Its load times
+// are the binary snapshot's plus reading and replaying a journal that has grown to the
+// compaction limit, the most a load ever replays.
+//
+// Usage: bench_save [runs]
+
+#include "SaveFormat.h"
+#include "SaveWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Counts values; stands in for the save SAX handler, which does a map insert per value
+struct CountingSax : json::json_sax_t {
+    std::size_t values = 0;
+    bool null() override { return ++values; }
+    bool boolean(bool) override { return ++values; }
+    bool number_integer(number_integer_t) override { return ++values; }
+    bool number_unsigned(number_unsigned_t) override { return ++values; }
+    bool number_float(number_float_t, const string_t&) override { return ++values; }
+    bool string(string_t&) override { return ++values; }
+    bool binary(binary_t&) override { return ++values; }
+    bool start_object(std::size_t) override { return true; }
+    bool key(string_t&) override { return true; }
+    bool end_object() override { return true; }
+    bool start_array(std::size_t) override { return true; }
+    bool end_array() override { return true; }
+    bool parse_error(std::size_t, const std::string&, const json::exception&) override { return false; }
+};
+
+SaveState makeState(int flagCount, int statCount, int itemCount) {
+    SaveState state;
+    state.currentScript = "intro";
+    state.currentScene = "a1_s07_bronze_gate";
+    for (int i = 0; i < flagCount; ++i) {
+        state.flags.push_back({intern("bench_flag_" + std::to_string(i)), i % 3 != 0});
+    }
+    for (int i = 0; i < statCount; ++i) {
+        state.stats.push_back({intern("bench_stat_" + std::to_string(i)), i * 7 - 40});
+    }
+    for (int i = 0; i < itemCount; ++i) {
+        state.inventory.emplace_back(intern("bench_item_" + std::to_string(i)), 1 + i % 99);
+    }
+    return state;
+}
+
+void writeFile(const fs::path& path, const std::uint8_t* data, std::size_t size) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+std::vector<std::uint8_t> readFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<std::uint8_t>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+struct Timings {
+    std::size_t bytes = 0;
+    double saveMs = 1e30;   // State -> bytes on disk
+    double domMs = 1e30;    // File -> json document
+    double saxMs = 1e30;    // File -> SAX events
+};
+
+Timings benchJson(const SaveState& state, const fs::path& path, int runs, json& loaded) {
+    Timings t;
+    for (int run = 0; run < runs; ++run) {
+        auto start = Clock::now();
+        std::string text = SaveWriter::toJson(state).dump(2);
+        writeFile(path, reinterpret_cast<const std::uint8_t*>(text.data()), text.size());
+        t.saveMs = std::min(t.saveMs, millisecondsSince(start));
+        t.bytes = text.size();
+
+        start = Clock::now();
+        std::vector<std::uint8_t> bytes = readFile(path);
+        loaded = json::parse(bytes.begin(), bytes.end());
+        t.domMs = std::min(t.domMs, millisecondsSince(start));
+
+        start = Clock::now();
+        bytes = readFile(path);
+        CountingSax sax;
+        json::sax_parse(bytes.begin(), bytes.end(), &sax);
+        t.saxMs = std::min(t.saxMs, millisecondsSince(start));
+    }
+    return t;
+}
+
+Timings benchBinary(const SaveState& state, const fs::path& path, int runs, json& loaded) {
+    Timings t;
+    for (int run = 0; run < runs; ++run) {
+        auto start = Clock::now();
+        std::vector<std::uint8_t> encoded = SaveFormat::encode(state);
+        writeFile(path, encoded.data(), encoded.size());
+        t.saveMs = std::min(t.saveMs, millisecondsSince(start));
+        t.bytes = encoded.size();
+
+        SaveFormat::Payload payload;
+        std::string error;
+        start = Clock::now();
+        std::vector<std::uint8_t> bytes = readFile(path);
+        if (!SaveFormat::decode(bytes.data(), bytes.size(), payload, error)) {
+            std::cerr << "Binary save rejected: " << error << std::endl;
+            std::exit(1);
+        }
+        loaded = json::from_cbor(payload.data, payload.data + payload.size);
+        t.domMs = std::min(t.domMs, millisecondsSince(start));
+
+        start = Clock::now();
+        bytes = readFile(path);
+        SaveFormat::decode(bytes.data(), bytes.size(), payload, error);
+        CountingSax sax;
+        json::sax_parse(payload.data, payload.data + payload.size, &sax, json::input_format_t::cbor);
+        t.saxMs = std::min(t.saxMs, millisecondsSince(start));
+    }
+    return t;
+}
+
+// Records GameStateManager journals before compacting (GameStateManager::JOURNAL_COMPACT_EVERY)
+constexpr int kJournalCompactEvery = 256;
+
+// One transition's records: a flag, an item, a location
+void appendTransition(std::vector<std::uint8_t>& records, int step) {
+    JournalRecord flag;
+    flag.type = JournalRecord::Type::SetFlag;
+    flag.key = intern("bench_flag_" + std::to_string(step % 40));
+    flag.value = 1;
+    SaveFormat::appendRecord(records, flag);
+    JournalRecord item;
+    item.type = JournalRecord::Type::AddItem;
+    item.key = intern("bench_item_" + std::to_string(step % 6));
+    item.value = 1;
+    SaveFormat::appendRecord(records, item);
+    JournalRecord location;
+    location.type = JournalRecord::Type::Location;
+    location.script = "intro";
+    location.scene = "a1_s07_bronze_gate";
+    SaveFormat::appendRecord(records, location);
+}
+
+// Stand-in for the state GameStateManager::replayJournal applies records to
+struct ReplayState {
+    std::unordered_map<Symbol, bool> flags;
+    std::unordered_map<Symbol, int> stats;
+    std::unordered_map<Symbol, int> items;
+    std::string script, scene;
+
+    void apply(const JournalRecord& record) {
+        switch (record.type) {
+            case JournalRecord::Type::SetFlag: flags[record.key] = record.value != 0; break;
+            case JournalRecord::Type::AddStat: stats[record.key] += record.value; break;
+            case JournalRecord::Type::AddItem: items[record.key] += record.value; break;
+            case JournalRecord::Type::RemoveItem: items[record.key] -= record.value; break;
+            case JournalRecord::Type::RemoveItemAt: break;
+            case JournalRecord::Type::Location: script = record.script; scene = record.scene; break;
+        }
+    }
+};
+
+// Append one transition, as SaveWriter does in journal mode; then load = the snapshot's load
+// plus reading and replaying a journal at the compaction limit
+Timings benchJournal(const SaveState& state, const Timings& snapshot, const fs::path& path, int runs) {
+    Timings t;
+    const std::uint32_t base = SaveFormat::snapshotChecksum(SaveFormat::encode(state));
+    std::vector<std::uint8_t> header = SaveFormat::journalHeader(base);
+    writeFile(path, header.data(), header.size());
+    for (int run = 0; run < runs; ++run) {
+        auto start = Clock::now();
+        std::vector<std::uint8_t> records;
+        appendTransition(records, run);
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size()));
+        out.flush();
+        t.saveMs = std::min(t.saveMs, millisecondsSince(start));
+        t.bytes = records.size();
+    }
+
+    std::vector<std::uint8_t> full = header;
+    for (int step = 0; step * 3 < kJournalCompactEvery; ++step) {
+        appendTransition(full, step);
+    }
+    writeFile(path, full.data(), full.size());
+    double replayMs = 1e30;
+    for (int run = 0; run < runs; ++run) {
+        auto start = Clock::now();
+        std::vector<std::uint8_t> bytes = readFile(path);
+        std::vector<JournalRecord> records;
+        std::string error;
+        if (!SaveFormat::readJournal(bytes.data(), bytes.size(), base, records, error) || !error.empty()) {
+            std::cerr << "Journal rejected: " << error << std::endl;
+            std::exit(1);
+        }
+        ReplayState replayed;
+        for (const JournalRecord& record : records) {
+            replayed.apply(record);
+        }
+        replayMs = std::min(replayMs, millisecondsSince(start));
+    }
+    t.domMs = snapshot.domMs + replayMs;
+    t.saxMs = snapshot.saxMs + replayMs;
+    return t;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int runs = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20;
+
+    fs::path directory = fs::temp_directory_path() / "uag_bench_save";
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+
+    struct Case {
+        const char* name;
+        int flags, stats, items;
+    };
+    for (const Case& c : {Case{"playthrough", 40, 8, 6}, Case{"large", 10000, 1000, 1000}}) {
+        SaveState state = makeState(c.flags, c.stats, c.items);
+        json fromJson;
+        json fromBinary;
+        Timings text = benchJson(state, directory / "save.json", runs, fromJson);
+        Timings binary = benchBinary(state, directory / "save.uasv", runs, fromBinary);
+        if (fromJson != fromBinary) {
+            std::cerr << "Formats loaded different saves" << std::endl;
+            return 1;
+        }
+
+        std::cout << c.name << ": " << c.flags << " flags, " << c.stats << " stats, " << c.items
+                  << " items, best of " << runs << " runs" << std::endl;
+        std::cout << std::left << std::setw(10) << "" << std::right << std::setw(12) << "bytes"
+                  << std::setw(12) << "save ms" << std::setw(12) << "load (dom)" << std::setw(12) << "load (sax)" << std::endl;
+        auto print = [](const char* name, const Timings& t) {
+            std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(3)
+                      << std::setw(12) << t.bytes << std::setw(12) << t.saveMs << std::setw(12) << t.domMs
+                      << std::setw(12) << t.saxMs << std::endl;
+        };
+        print("json", text);
+        print("binary", binary);
+        print("journal", benchJournal(state, binary, directory / "save.uasj", runs));
+        std::cout << std::endl;
+    }
+
+    fs::remove_all(directory, ec);
+    return 0;
+}
@@ -0,0 +1,273 @@
+// Script parsing benchmark: DOM (nlohmann::json::parse) vs streaming SAX vs lazy loading
+//
+// Generates synthetic scripts with 1k, 10k and 100k scenes, loads each one with every
+// parser, checks the results are identical and reports time, allocation count and
+// peak heap usage for every run. The lazy run opens the script and plays through
+// kVisitedScenes scenes, which is what a session actually touches.
+//
+// Usage: bench_script_parse [runs]
+
+#include "ScriptParser.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// ---- Allocation tracking ----
+// Every allocation carries a small header with its size so peak usage can be tracked
+namespace {
+
+constexpr std::size_t kHeaderSize = alignof(std::max_align_t);
+
+std::atomic<std::size_t> allocationCount{0};
+std::atomic<std::size_t> liveBytes{0};
+std::atomic<std::size_t> peakBytes{0};
+
+void* trackedAlloc(std::size_t size) {
+    void* block = std::malloc(size + kHeaderSize);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t*>(block) = size;
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    std::size_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    return static_cast<char*>(block) + kHeaderSize;
+}
+
+void trackedFree(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    void* block = static_cast<char*>(ptr) - kHeaderSize;
+    liveBytes.fetch_sub(*static_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return trackedAlloc(size); }
+void* operator new[](std::size_t size) { return trackedAlloc(size); }
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { trackedFree(ptr); }
+
+namespace {
+
+constexpr std::uint32_t kVisitedScenes = 50;
+
+struct RunStats {
+    double milliseconds = 0.0;
+    std::size_t allocations = 0;
+    std::size_t peakBytes = 0;
+};
+
+// Write a script shaped like the authored ones: branching choices, conditions and effects
+void writeSyntheticScript(const std::string& path, int sceneCount) {
+    std::ofstream out(path);
+    out << "{\n  \"scriptId\": \"bench_" << sceneCount << "\",\n"
+        << "  \"title\": \"Benchmark Script\",\n"
+        << "  \"metadata\": { \"chapter\": 1, \"unlocks\": [\"bench_next\"], \"estimatedTime\": \"1h\" },\n"
+        << "  \"scenes\": [\n";
+
+    for (int i = 0; i < sceneCount; ++i) {
+        int next = (i + 1) % sceneCount;
+        int skip = (i * 7 + 3) % sceneCount;
+        out << "    {\n"
+            << "      \"id\": \"scene_" << i << "\",\n"
+            << "      \"background\": \"bg_" << (i % 40) << "\",\n"
+            << "      \"text\": \"Scene " << i << " text. The wind moves through the old trees and the road "
+            << "bends toward the mountains, where something waits for you in the dark.\",\n"
+            << "      \"speaker\": \"Narrator\",\n"
+            << "      \"speakerColor\": \"#E0E0FF\",\n"
+            << "      \"music\": \"mus_" << (i % 8) << "\",\n"
+            << "      \"choices\": [\n"
+            << "        { \"text\": \"Continue\", \"nextScene\": \"scene_" << next << "\" },\n"
+            << "        { \"text\": \"Take the hidden path\", \"nextScene\": \"scene_" << skip << "\", "
+            << "\"condition\": { \"flag\": \"flag_" << (i % 100) << "\", \"flagsNot\": \"flag_" << ((i + 1) % 100) << "\" } }\n"
+            << "      ]";
+        if (i % 5 == 0) {
+            out << ",\n      \"effects\": {\n"
+                << "        \"addFlag\": \"flag_" << (i % 100) << "\",\n"
+                << "        \"modifyStat\": { \"courage\": 1, \"wisdom\": -1 },\n"
+                << "        \"addItems\": [ { \"id\": \"item_" << (i % 30) << "\", \"quantity\": 2 } ]\n"
+                << "      }";
+        }
+        out << "\n    }" << (i + 1 < sceneCount ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Visit scenes the way SceneManager does: the scene itself, then every scene it leads to
+std::vector<std::uint32_t> playThrough(const GameScript& script) {
+    std::vector<std::uint32_t> visited;
+    std::uint32_t index = 0;
+    while (visited.size() < kVisitedScenes && index < script.sceneCount()) {
+        const Scene* scene = script.scene(index);
+        if (!scene || scene->choices.empty()) {
+            break;
+        }
+        visited.push_back(index);
+        for (const auto& choice : scene->choices) {
+            if (choice.target < script.sceneCount()) {
+                script.scene(choice.target);
+                visited.push_back(choice.target);
+            }
+        }
+        index = scene->choices.back().target;
+    }
+    return visited;
+}
+
+template <typename Load>
+RunStats measure(Load load, std::optional<GameScript>& result) {
+    result.reset();
+
+    std::size_t allocationsBefore = allocationCount.load();
+    std::size_t liveBefore = liveBytes.load();
+    peakBytes.store(liveBefore);
+
+    auto start = std::chrono::steady_clock::now();
+    result = load();
+    auto end = std::chrono::steady_clock::now();
+
+    RunStats stats;
+    stats.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    stats.allocations = allocationCount.load() - allocationsBefore;
+    stats.peakBytes = peakBytes.load() - liveBefore;
+    return stats;
+}
+
+bool sameConditions(const std::optional<Condition>& a, const std::optional<Condition>& b) {
+    if (a.has_value() != b.has_value()) return false;
+    return !a || (a->flag == b->flag && a->flagsNot == b->flagsNot && a->requiredValue == b->requiredValue &&
+                  a->expression == b->expression);
+}
+
+bool sameEffects(const std::optional<Effects>& a, const std::optional<Effects>& b) {
+    if (a.has_value() != b.has_value()) return false;
+    return !a || a->steps == b->steps;
+}
+
+bool sameScenes(const Scene* x, const Scene* y) {
+    if (!x || !y) return false;
+    if (x->id != y->id || x->symbol != y->symbol || x->background != y->background || x->text != y->text ||
+        x->speaker != y->speaker || x->speakerColor != y->speakerColor ||
+        x->choices.size() != y->choices.size() || !sameEffects(x->effects, y->effects)) {
+        return false;
+    }
+    for (std::size_t c = 0; c < x->choices.size(); ++c) {
+        const Choice& p = x->choices[c];
+        const Choice& q = y->choices[c];
+        if (p.text != q.text || p.nextScene != q.nextScene || p.nextScript != q.nextScript ||
+            p.target != q.target || !sameConditions(p.condition, q.condition)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Compares the given scenes, or all of them when only is empty
+bool sameScripts(const GameScript& a, const GameScript& b, const std::vector<std::uint32_t>& only = {}) {
+    if (a.scriptId != b.scriptId || a.title != b.title ||
+        a.metadata.chapter != b.metadata.chapter || a.metadata.unlocks != b.metadata.unlocks ||
+        a.metadata.estimatedTime != b.metadata.estimatedTime ||
+        a.sceneCount() != b.sceneCount()) {
+        return false;
+    }
+
+    if (!only.empty()) {
+        for (std::uint32_t i : only) {
+            if (!sameScenes(a.scene(i), b.scene(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    for (std::uint32_t i = 0; i < a.sceneCount(); ++i) {
+        if (!sameScenes(a.scene(i), b.scene(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int runs = argc > 1 ? std::max(1, std::atoi(argv[1])) : 3;
+
+    auto dir = std::filesystem::temp_directory_path() / "uag_bench_script_parse";
+    std::filesystem::create_directories(dir);
+
+    std::cout << std::left << std::setw(9) << "scenes" << std::setw(11) << "parser"
+              << std::right << std::setw(12) << "best ms" << std::setw(14) << "allocations"
+              << std::setw(14) << "peak KiB" << std::endl;
+
+    bool allMatch = true;
+    for (int sceneCount : {1000, 10000, 100000}) {
+        std::string path = (dir / ("bench_" + std::to_string(sceneCount) + ".json")).string();
+        writeSyntheticScript(path, sceneCount);
+
+        std::optional<GameScript> dom;
+        std::optional<GameScript> streaming;
+        std::optional<GameScript> lazy;
+        RunStats best[3];
+
+        auto loadDom = [&path] { return ScriptParser::loadJsonScript(path, JsonParseMode::Dom); };
+        auto loadStreaming = [&path] { return ScriptParser::loadJsonScript(path, JsonParseMode::Streaming); };
+        auto loadLazy = [&path] {
+            auto script = ScriptParser::loadLazyScript(path);
+            if (script) {
+                playThrough(*script);
+            }
+            return script;
+        };
+
+        for (int run = 0; run < runs; ++run) {
+            RunStats stats[3] = {measure(loadDom, dom), measure(loadStreaming, streaming), measure(loadLazy, lazy)};
+            for (int i = 0; i < 3; ++i) {
+                if (run == 0 || stats[i].milliseconds < best[i].milliseconds) best[i] = stats[i];
+            }
+        }
+
+        if (!dom || !streaming || !lazy) {
+            std::cerr << "Failed to load " << path << std::endl;
+            return 1;
+        }
+
+        const char* names[3] = {"dom", "streaming", "lazy"};
+        for (int i = 0; i < 3; ++i) {
+            std::cout << std::left << std::setw(9) << sceneCount << std::setw(11) << names[i]
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << best[i].milliseconds
+                      << std::setw(14) << best[i].allocations
+                      << std::setw(14) << best[i].peakBytes / 1024 << std::endl;
+        }
+
+        if (!sameScripts(*dom, *streaming)) {
+            std::cerr << "Mismatch between DOM and streaming results for " << sceneCount << " scenes" << std::endl;
+            allMatch = false;
+        }
+        if (!sameScripts(*streaming, *lazy, playThrough(*lazy))) {
+            std::cerr << "Mismatch between streaming and lazy results for " << sceneCount << " scenes" << std::endl;
+            allMatch = false;
+        }
+
+        std::filesystem::remove(path);
+    }
+
+    std::filesystem::remove(dir);
+    return allMatch ? 0 : 1;
+}
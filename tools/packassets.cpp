@@ -0,0 +1,194 @@
+// Asset packer: bundles the asset directory into a single mmappable archive (see AssetPackFormat.h)
+//
+// Usage: packassets <asset-dir> <output.pak> [--prefix <path-prefix>] [--skip <relative-path>]...
+//                   [--manifest <manifest.json>]
+//
+// Files are stored under <prefix><path relative to asset-dir>, e.g. "assets/images/logo.png",
+// which is exactly the path the game asks ResourceManager for. The asset manifest is generated
+// from the same files and stored in the pack as <prefix>manifest.json; --manifest also writes
+// it out for running from loose files.
+
+#include "AssetManifest.h"
+#include "AssetPackFormat.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace AssetPackFormat;
+
+namespace {
+
+struct InputFile {
+    std::string name;
+    fs::path source;     // Empty for generated files
+    std::string contents;  // Generated files only
+    std::uint32_t size = 0;
+};
+
+std::uint32_t alignUp(std::uint64_t value, std::uint32_t alignment) {
+    return static_cast<std::uint32_t>((value + alignment - 1) / alignment * alignment);
+}
+
+bool isSkipped(const std::string& relative, const std::vector<std::string>& skips) {
+    for (const auto& skip : skips) {
+        if (relative == skip || relative.compare(0, skip.size() + 1, skip + "/") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: packassets <asset-dir> <output.pak> [--prefix <path-prefix>] [--skip <relative-path>]..."
+                  << " [--manifest <manifest.json>]" << std::endl;
+        return 1;
+    }
+
+    fs::path root = argv[1];
+    std::string output = argv[2];
+    std::string prefix = "assets/";
+    std::vector<std::string> skips;
+    std::string manifestOutput;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--prefix") == 0) {
+            prefix = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--skip") == 0) {
+            skips.push_back(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--manifest") == 0) {
+            manifestOutput = argv[i + 1];
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::error_code ec;
+    std::vector<InputFile> inputs;
+    for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file()) {
+            continue;
+        }
+        std::string relative = fs::relative(it->path(), root).generic_string();
+        if (isSkipped(relative, skips) || relative == "manifest.json") {
+            continue;
+        }
+        std::uintmax_t size = it->file_size();
+        if (size > 0xFFFFFFFFu) {
+            std::cerr << "File too large for pack: " << it->path() << std::endl;
+            return 1;
+        }
+        inputs.push_back({prefix + relative, it->path(), {}, static_cast<std::uint32_t>(size)});
+    }
+    if (ec) {
+        std::cerr << "Failed to read asset directory " << root << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    AssetManifest manifest;
+    skips.push_back("manifest.json");
+    if (!manifest.scan(root.string(), prefix, skips)) {
+        return 1;
+    }
+    if (!manifestOutput.empty() && !manifest.saveToFile(manifestOutput)) {
+        return 1;
+    }
+    InputFile manifestFile;
+    manifestFile.name = prefix + "manifest.json";
+    manifestFile.contents = manifest.toJsonString();
+    manifestFile.size = static_cast<std::uint32_t>(manifestFile.contents.size());
+    inputs.push_back(std::move(manifestFile));
+
+    // Sorted so the same inputs always produce the same archive
+    std::sort(inputs.begin(), inputs.end(), [](const InputFile& a, const InputFile& b) { return a.name < b.name; });
+
+    PackHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.entryCount = static_cast<std::uint32_t>(inputs.size());
+    header.slotCount = 16;
+    while (header.slotCount < header.entryCount * 2) {
+        header.slotCount *= 2;
+    }
+
+    std::string names;
+    std::vector<PackEntry> entries;
+    for (const auto& input : inputs) {
+        PackEntry entry{};
+        entry.hash = hashPath(input.name);
+        entry.nameOffset = static_cast<std::uint32_t>(names.size());
+        entry.nameLength = static_cast<std::uint32_t>(input.name.size());
+        entry.dataSize = input.size;
+        names += input.name;
+        entries.push_back(entry);
+    }
+
+    std::vector<std::uint32_t> slots(header.slotCount, kEmptySlot);
+    for (std::uint32_t i = 0; i < header.entryCount; ++i) {
+        std::uint32_t pos = firstSlot(entries[i].hash, header.slotCount);
+        while (slots[pos] != kEmptySlot) {
+            pos = (pos + 1) & (header.slotCount - 1);
+        }
+        slots[pos] = i;
+    }
+
+    header.entryTableOffset = sizeof(PackHeader);
+    header.slotTableOffset = header.entryTableOffset + header.entryCount * sizeof(PackEntry);
+    header.nameTableOffset = header.slotTableOffset + header.slotCount * sizeof(std::uint32_t);
+    header.nameTableSize = static_cast<std::uint32_t>(names.size());
+
+    std::uint64_t offset = static_cast<std::uint64_t>(header.nameTableOffset) + header.nameTableSize;
+    for (auto& entry : entries) {
+        offset = alignUp(offset, kBlobAlignment);
+        entry.dataOffset = static_cast<std::uint32_t>(offset);
+        offset += entry.dataSize;
+        if (offset > 0xFFFFFFFFu) {
+            std::cerr << "Asset pack would exceed 4 GiB" << std::endl;
+            return 1;
+        }
+    }
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to write asset pack: " << output << std::endl;
+        return 1;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PackEntry));
+    out.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(std::uint32_t));
+    out.write(names.data(), names.size());
+
+    std::uint64_t written = static_cast<std::uint64_t>(header.nameTableOffset) + header.nameTableSize;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        // Zero padding up to the blob's aligned offset
+        static const char zeros[kBlobAlignment] = {};
+        out.write(zeros, entries[i].dataOffset - written);
+
+        std::string data = inputs[i].contents;
+        if (!inputs[i].source.empty()) {
+            std::ifstream in(inputs[i].source, std::ios::binary);
+            data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        if (data.size() != inputs[i].size) {
+            std::cerr << "Failed to read " << inputs[i].source << std::endl;
+            return 1;
+        }
+        out.write(data.data(), data.size());
+        written = static_cast<std::uint64_t>(entries[i].dataOffset) + entries[i].dataSize;
+    }
+
+    if (!out) {
+        std::cerr << "Failed to write asset pack: " << output << std::endl;
+        return 1;
+    }
+    std::cout << "Packed " << inputs.size() << " files (" << manifest.size() << " in the manifest) into " << output << " (" << written << " bytes)" << std::endl;
+    return 0;
+}
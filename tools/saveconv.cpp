@@ -0,0 +1,66 @@
+// Save converter: binary saves (.uasv) to indented JSON for debugging, and JSON saves
+// (including ones written before the binary format) back to binary
+//
+// Usage: saveconv <input> [output]
+//
+// The direction follows the input: a binary save is exported as JSON (default output
+// <input>.json), anything else is read as JSON and written as a binary save (default
+// output <input> with a .uasv extension).
+
+#include "SaveFormat.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: saveconv <input> [output]" << std::endl;
+        return 1;
+    }
+    
+    std::string input = argv[1];
+    std::ifstream in(input, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open " << input << std::endl;
+        return 1;
+    }
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    
+    std::string output;
+    std::vector<std::uint8_t> converted;
+    try {
+        if (SaveFormat::isBinary(bytes.data(), bytes.size())) {
+            SaveFormat::Payload payload;
+            std::string error;
+            if (!SaveFormat::decode(bytes.data(), bytes.size(), payload, error)) {
+                std::cerr << input << ": " << error << std::endl;
+                return 1;
+            }
+            std::string text = nlohmann::json::from_cbor(payload.data, payload.data + payload.size).dump(2);
+            converted.assign(text.begin(), text.end());
+            output = argc == 3 ? argv[2] : input + ".json";
+        } else {
+            converted = SaveFormat::encode(nlohmann::json::parse(bytes.begin(), bytes.end()));
+            output = argc == 3 ? argv[2] : fs::path(input).replace_extension(SaveFormat::kExtension).string();
+        }
+    } catch (const nlohmann::json::exception& e) {
+        std::cerr << input << ": " << e.what() << std::endl;
+        return 1;
+    }
+    
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(converted.data()), static_cast<std::streamsize>(converted.size()));
+    if (!out) {
+        std::cerr << "Failed to write " << output << std::endl;
+        return 1;
+    }
+    
+    std::cout << "Converted " << input << " (" << bytes.size() << " bytes) -> " << output
+              << " (" << converted.size() << " bytes)" << std::endl;
+    return 0;
+}
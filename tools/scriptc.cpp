@@ -0,0 +1,30 @@
+// Script compiler: converts authoring JSON scripts into the mmappable .uasc format
+//
+// Usage: scriptc <input.json> [output.uasc]
+
+#include "ScriptParser.h"
+#include "ScriptCompiler.h"
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: scriptc <input.json> [output.uasc]" << std::endl;
+        return 1;
+    }
+    
+    std::string input = argv[1];
+    std::string output = argc == 3 ? argv[2] : ScriptParser::compiledPathFor(input);
+    
+    auto script = ScriptParser::loadJsonScript(input);
+    if (!script) {
+        return 1;
+    }
+    
+    if (!ScriptCompiler::compile(*script, output)) {
+        return 1;
+    }
+    
+    std::cout << "Compiled " << input << " -> " << output 
+              << " (" << script->scenes.size() << " scenes)" << std::endl;
+    return 0;
+}